@@ -0,0 +1,139 @@
+/**
+ * @file boottime.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Boot timeline, records how long each phase of kernel_main takes.
+*/
+#ifndef ARC_INTERFACE_BOOTTIME_H
+#define ARC_INTERFACE_BOOTTIME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Number of phases kept, older phases are overwritten once this is exceeded
+#define ARC_BOOTTIME_MAX_RECORDS 32
+
+struct ARC_BootTimeRecord {
+	/// Name of the phase
+	const char *name;
+	/// TSC value at the start of the phase
+	uint64_t start;
+	/// TSC value at the end of the phase
+	uint64_t end;
+	/// Value returned by the phase, 0 on success
+	int status;
+};
+
+/**
+ * Read the TSC
+ *
+ * Earlier instructions are kept from being counted towards
+ * whatever is timed next.
+ *
+ * @return the current TSC value, 0 if there is no TSC.
+*/
+static inline uint64_t boottime_rdtsc() {
+#ifdef ARC_TARGET_ARCH_X86_64
+	uint32_t low = 0;
+	uint32_t high = 0;
+
+	__asm__ volatile("lfence; rdtsc" : "=a"(low), "=d"(high) :: "memory");
+
+	return ((uint64_t)high << 32) | low;
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Layout of IA32_TSC_AUX. The MSR belongs to the arch code, which programs it
+ * on each processor as it is brought up. The processor index is kept in the
+ * low 12 bits and the NUMA node above it, the same layout Linux uses, so what
+ * userspace reads back with RDTSCP or RDPID means the same thing.
+*/
+#define ARC_TSC_AUX_CPU_MASK 0xFFF
+#define ARC_TSC_AUX_NODE_SHIFT 12
+#define ARC_TSC_AUX(__cpu, __node) \
+	((((uint32_t)(__node)) << ARC_TSC_AUX_NODE_SHIFT) | ((uint32_t)(__cpu) & ARC_TSC_AUX_CPU_MASK))
+
+/// Time a call to an init function, evaluates to its return value
+#define ARC_BOOTTIME_PHASE(__name, __call) \
+	({ boottime_begin(__name); int __ret = (__call); boottime_end(__ret); __ret; })
+
+/**
+ * Start a new boot phase
+ *
+ * Phases do not nest, and are only expected to be recorded
+ * by the BSP while kernel_main is running.
+ *
+ * @param const char *name - Name of the phase, must outlive the timeline.
+*/
+void boottime_begin(const char *name);
+
+/**
+ * End the current boot phase
+ *
+ * @param int status - Status of the phase, 0 on success.
+*/
+void boottime_end(int status);
+
+/**
+ * Copy the recorded phases out of the timeline
+ *
+ * Records are copied oldest first, start and end times are
+ * raw TSC values.
+ *
+ * @param struct ARC_BootTimeRecord *records - Array to copy the records into.
+ * @param int max - Number of entries in records.
+ * @return the number of records copied.
+*/
+int boottime_get_records(struct ARC_BootTimeRecord *records, int max);
+
+/**
+ * Get the TSC frequency
+ *
+ * @return the frequency of the TSC in Hz, 0 if it could not be determined.
+*/
+uint64_t boottime_tsc_hz();
+
+/**
+ * Read the timeline as a text table
+ *
+ * Meant to back the read operation of a /dev/ node. Times are
+ * in microseconds relative to the first phase, or in TSC ticks
+ * if the TSC frequency is unknown.
+ *
+ * @param void *buffer - Buffer to read into.
+ * @param size_t size - Number of bytes to read.
+ * @param size_t offset - Offset into the table to start reading from.
+ * @return the number of bytes read.
+*/
+size_t boottime_read(void *buffer, size_t size, size_t offset);
+
+/**
+ * Print the timeline as a text table
+*/
+void boottime_print();
+
+#endif
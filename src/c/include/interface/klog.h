@@ -0,0 +1,133 @@
+/**
+ * @file klog.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Binary kernel log. Messages are recorded into per-CPU rings with their
+ * raw arguments, and only formatted once something reads them back.
+*/
+#ifndef ARC_INTERFACE_KLOG_H
+#define ARC_INTERFACE_KLOG_H
+
+#include <interface/loglevel.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef ARC_KLOG_MAX_CPUS
+/// Number of rings, processors beyond this share a ring
+#define ARC_KLOG_MAX_CPUS 8
+#endif
+
+#ifndef ARC_KLOG_RING_SIZE
+/// Number of records in each ring, must be a power of two
+#define ARC_KLOG_RING_SIZE 128
+#endif
+
+/// Number of arguments kept per record, further arguments are dropped
+#define ARC_KLOG_MAX_ARGS 8
+/// Space in each record that %s arguments are copied into
+#define ARC_KLOG_STRING_SPACE 48
+
+// Same values as ARC_LOG_*, so levels compare the same way in both
+#define ARC_KLOG_LEVEL_ERR  ARC_LOG_ERR
+#define ARC_KLOG_LEVEL_WARN ARC_LOG_WARN
+#define ARC_KLOG_LEVEL_INFO ARC_LOG_INFO
+
+struct ARC_KLogRecord {
+	/// TSC value at the time the message was recorded
+	uint64_t timestamp;
+	/// Static string naming where the message came from
+	const char *site;
+	/// Format string, must be static
+	const char *format;
+	/// Raw arguments, %s arguments are offsets into strings
+	uint64_t args[ARC_KLOG_MAX_ARGS];
+	uint16_t cpu;
+	uint8_t level;
+	uint8_t argc;
+	char strings[ARC_KLOG_STRING_SPACE];
+};
+
+struct ARC_KLogReader {
+	/// Next record to be read from each ring
+	uint64_t tail[ARC_KLOG_MAX_CPUS];
+	/// Number of records overwritten before they could be read
+	uint64_t dropped;
+};
+
+/**
+ * Take processor indices from IA32_TSC_AUX from now on
+ *
+ * Called by the arch code once every processor has had IA32_TSC_AUX
+ * programmed with ARC_TSC_AUX(). Records then read it back with RDTSCP
+ * instead of executing CPUID. Must not be called on processors without
+ * RDTSCP.
+*/
+void klog_use_tsc_aux();
+
+/**
+ * Record a message into the current processor's ring
+ *
+ * Does not take any locks and does not format the message,
+ * only the arguments are copied, so it is safe to call from
+ * hot paths and interrupt handlers. Use ARC_KLOG rather than
+ * calling this directly.
+ *
+ * @param int level - One of ARC_KLOG_LEVEL_*.
+ * @param const char *site - Static string naming the caller.
+ * @param const char *format - Static printf style format string.
+ * @return zero on success, -1 if the message could not be recorded.
+*/
+int klog_record(int level, const char *site, const char *format, ...) __attribute__((format(__printf__, 3, 4)));
+
+/**
+ * Start a reader at the oldest record still held
+ *
+ * @param struct ARC_KLogReader *reader - Reader to initialize.
+*/
+void klog_reader_init(struct ARC_KLogReader *reader);
+
+/**
+ * Format the next record as a line of text
+ *
+ * Records from all processors are returned in timestamp order.
+ * Each reader keeps its own position, so it can back the read
+ * operation of a /dev/kmsg style node with one reader per open.
+ *
+ * @param struct ARC_KLogReader *reader - Reader to read with.
+ * @param char *buffer - Buffer to format the line into.
+ * @param size_t size - Size of buffer, longer lines are truncated.
+ * @return length of the line, 0 if there is nothing new.
+*/
+size_t klog_read(struct ARC_KLogReader *reader, char *buffer, size_t size);
+
+/**
+ * Print every record that has not been printed yet
+ *
+ * If another processor is already draining, returns without
+ * waiting for it.
+*/
+void klog_drain();
+
+#endif
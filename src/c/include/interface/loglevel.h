@@ -0,0 +1,140 @@
+/**
+ * @file loglevel.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Per-subsystem log levels and per call site rate limiting for ARC_DEBUG.
+*/
+#ifndef ARC_INTERFACE_LOGLEVEL_H
+#define ARC_INTERFACE_LOGLEVEL_H
+
+#include <stdint.h>
+
+#define ARC_LOG_ERR  1
+#define ARC_LOG_WARN 2
+#define ARC_LOG_INFO 3
+
+#define ARC_LOG_SUBSYS_KERNEL    0
+#define ARC_LOG_SUBSYS_INTERFACE 1
+#define ARC_LOG_SUBSYS_MM        2
+#define ARC_LOG_SUBSYS_FS        3
+#define ARC_LOG_SUBSYS_MP        4
+#define ARC_LOG_SUBSYS_ARCH      5
+#define ARC_LOG_SUBSYS_ACPI      6
+#define ARC_LOG_SUBSYS_DRIVERS   7
+#define ARC_LOG_SUBSYS_USERSPACE 8
+#define ARC_LOG_SUBSYS_COUNT     9
+
+/*
+ * Most verbose level compiled in for each subsystem, messages above it are
+ * removed at compile time. The runtime level starts out at the same value.
+*/
+#ifndef ARC_LOG_LEVEL_DEFAULT
+#define ARC_LOG_LEVEL_DEFAULT ARC_LOG_INFO
+#endif
+#ifndef ARC_LOG_LEVEL_KERNEL
+#define ARC_LOG_LEVEL_KERNEL ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_INTERFACE
+#define ARC_LOG_LEVEL_INTERFACE ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_MM
+#define ARC_LOG_LEVEL_MM ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_FS
+#define ARC_LOG_LEVEL_FS ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_MP
+#define ARC_LOG_LEVEL_MP ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_ARCH
+#define ARC_LOG_LEVEL_ARCH ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_ACPI
+#define ARC_LOG_LEVEL_ACPI ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_DRIVERS
+#define ARC_LOG_LEVEL_DRIVERS ARC_LOG_LEVEL_DEFAULT
+#endif
+#ifndef ARC_LOG_LEVEL_USERSPACE
+#define ARC_LOG_LEVEL_USERSPACE ARC_LOG_LEVEL_DEFAULT
+#endif
+
+#ifndef ARC_LOG_RATELIMIT_BURST
+/// Number of messages a call site may print back to back
+#define ARC_LOG_RATELIMIT_BURST 10
+#endif
+
+#ifndef ARC_LOG_RATELIMIT_PERIOD_MS
+/// A call site regains one message every period
+#define ARC_LOG_RATELIMIT_PERIOD_MS 500
+#endif
+
+/**
+ * Token bucket of a single call site
+ *
+ * Packed into one word so it can be updated from any processor or
+ * interrupt handler without a lock. The low 16 bits are the tokens
+ * used, the next 16 the number of messages suppressed since one was
+ * last let through, and the upper 32 the time of the last refill in
+ * milliseconds. A zeroed bucket is full.
+*/
+struct ARC_LogRateLimit {
+	uint64_t state;
+};
+
+/// Current runtime level of each subsystem
+extern uint8_t Arc_LogLevels[ARC_LOG_SUBSYS_COUNT];
+
+/**
+ * Set the runtime level of a subsystem
+ *
+ * Levels above the one compiled in have no effect.
+ *
+ * @param int subsystem - One of ARC_LOG_SUBSYS_*.
+ * @param int level - One of ARC_LOG_ERR, ARC_LOG_WARN or ARC_LOG_INFO.
+ * @return zero on success, -1 if the subsystem or level is invalid.
+*/
+int loglevel_set(int subsystem, int level);
+
+/**
+ * Get the runtime level of a subsystem
+ *
+ * @param int subsystem - One of ARC_LOG_SUBSYS_*.
+ * @return the level of the subsystem, -1 if it is invalid.
+*/
+int loglevel_get(int subsystem);
+
+/**
+ * Take a token from a call site's bucket
+ *
+ * When a message gets through after others were suppressed, the
+ * number suppressed is printed first.
+ *
+ * @param struct ARC_LogRateLimit *limit - Bucket of the call site.
+ * @param const char *site - Name of the call site, for the suppressed message.
+ * @return 1 if the message should be printed, 0 if it should be dropped.
+*/
+int loglevel_ratelimit(struct ARC_LogRateLimit *limit, const char *site);
+
+#endif
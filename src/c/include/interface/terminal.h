@@ -28,6 +28,7 @@
 #define ARC_INTERFACE_TERMINAL_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <lib/atomics.h>
 
 /**
@@ -59,6 +60,21 @@ typedef struct {
 	}
 
 
+#ifndef ARC_TERM_SCROLLBACK
+/// Number of lines kept after they have scrolled off the screen
+#define ARC_TERM_SCROLLBACK 1024
+#endif
+
+#ifndef ARC_TERM_COM_RING_SIZE
+/// Size of the buffer serial output is queued in, must be a power of two
+#define ARC_TERM_COM_RING_SIZE 0x4000
+#endif
+
+#ifndef ARC_TERM_COM_FIFO_SIZE
+/// Number of bytes written to the UART each time its FIFO empties
+#define ARC_TERM_COM_FIFO_SIZE 16
+#endif
+
 /**
  * Put a character into the terminal stream
  * 
@@ -71,6 +87,26 @@ typedef struct {
 */
 void term_putchar(char c);
 
+/**
+ * Write out all queued serial output
+ *
+ * Busy-polls the COM port until every character handed to
+ * term_putchar so far has been sent. Output that does not fit
+ * into the UART right away is only pushed out by this, so it
+ * must be called periodically, kernel_main's idle loop does so
+ * after every wakeup.
+*/
+void term_flush();
+
+/**
+ * Make serial output synchronous
+ *
+ * Flushes queued output and makes every further term_putchar
+ * wait for the character to be sent. Only meant for paths that
+ * are not coming back, like a panic.
+*/
+void term_set_sync();
+
 /**
  * A function to draw the terminal to its framebuffer
  *
@@ -82,6 +118,78 @@ void term_putchar(char c);
 */
 void term_draw();
 
+/**
+ * Read the terminal's scrollback and screen as text
+ *
+ * Meant to back the read operation of a VFS node. Lines are
+ * read oldest first up to the one the cursor is on, each
+ * followed by a newline.
+ *
+ * @param void *buffer - Buffer to read into.
+ * @param size_t size - Number of bytes to read.
+ * @param size_t offset - Offset into the text to start reading from.
+ * @return the number of bytes read.
+*/
+size_t term_read_scrollback(void *buffer, size_t size, size_t offset);
+
+/**
+ * Get the number of bytes term_draw has written to the framebuffer
+ *
+ * Useful for measuring how much a given amount of output costs
+ * to display.
+*/
+uint64_t term_fb_bytes_written();
+
+/**
+ * Change the font the terminal is drawn with
+ *
+ * Expands every glyph of the font into the framebuffer's pixel
+ * format and lays the terminal out again in cells of the new
+ * size, keeping the last lines of text. Fonts larger than the
+ * character ROM need the allocator to have been initialized.
+ *
+ * @param uint8_t *glyphs - 256 glyphs of height rows each, rows are (width + 7) / 8 bytes, most significant bit first. NULL for the character ROM.
+ * @param int width - Width of a glyph in pixels, ignored if glyphs is NULL.
+ * @param int height - Height of a glyph in pixels, ignored if glyphs is NULL.
+ * @param int scale - Factor to scale each glyph up by.
+ * @return zero on success, -1 if the current font is kept.
+*/
+int term_set_font(uint8_t *glyphs, int width, int height, int scale);
+
+/**
+ * Change the colors the terminal is drawn with
+ *
+ * @param uint32_t fg - Foreground color, in the framebuffer's pixel format.
+ * @param uint32_t bg - Background color, in the framebuffer's pixel format.
+ * @return zero on success, -1 if there is no font to draw with.
+*/
+int term_set_colors(uint32_t fg, uint32_t bg);
+
 int init_terminal();
 
+/**
+ * Move the terminal's text into a ring with room for scrollback
+ *
+ * Until this is called the text is kept in a small static
+ * buffer. Must be called after the allocator has been
+ * initialized.
+ *
+ * @param int history - Number of lines to keep after they have scrolled off the screen.
+ * @return zero on success, -1 if the static buffer is kept.
+*/
+int init_terminal_scrollback(int history);
+
+/**
+ * Start drawing the terminal through a shadow buffer
+ *
+ * Allocates a RAM copy of the framebuffer which glyphs are
+ * rendered into, the framebuffer itself then only receives
+ * whole row copies. Must be called after the allocator has been
+ * initialized, until then term_draw writes to the framebuffer
+ * directly.
+ *
+ * @return zero on success, -1 if the terminal keeps drawing directly.
+*/
+int init_terminal_shadow();
+
 #endif
@@ -31,6 +31,14 @@
     #define UACPI_DEFAULT_LOG_LEVEL UACPI_LOG_INFO
 #endif
 
+/*
+ * Most verbose level compiled in, messages above it are dropped at compile
+ * time regardless of the level set with uacpi_context_set_log_level.
+ */
+#ifndef UACPI_MAX_LOG_LEVEL
+    #define UACPI_MAX_LOG_LEVEL UACPI_LOG_DEBUG
+#endif
+
 #define UACPI_DEFAULT_LOOP_TIMEOUT_SECONDS 30
 #define UACPI_DEFAULT_MAX_CALL_STACK_DEPTH 256
 
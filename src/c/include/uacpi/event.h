@@ -84,6 +84,9 @@ typedef enum uacpi_event_info {
 
     // Hardware status bit is set
     UACPI_EVENT_INFO_HW_STATUS = (1 << 5),
+
+    // Event fired too often and is being polled instead (GPEs only)
+    UACPI_EVENT_INFO_POLLING = (1 << 6),
 } uacpi_event_info;
 
 UACPI_ALWAYS_ERROR_FOR_REDUCED_HARDWARE(
@@ -91,12 +94,63 @@ uacpi_status uacpi_fixed_event_info(
     uacpi_fixed_event event, uacpi_event_info *out_info
 ))
 
+/*
+ * Time it takes to handle an event, in the 100ns ticks of
+ * uacpi_kernel_get_ticks(). It's measured from the SCI (or poll) that
+ * detected the event to the completion of its handler, for GPEs with AML
+ * handlers that is the moment the GPE is re-enabled after the method ran.
+ */
+typedef struct uacpi_event_latency_stats {
+    // Number of times handling of the event completed
+    uacpi_u32 count;
+
+    uacpi_u64 min_ticks;
+    uacpi_u64 avg_ticks;
+    uacpi_u64 max_ticks;
+
+    /*
+     * Latency 99% of the events stayed within. Only accurate to the next
+     * power of two, as it's taken from a histogram.
+     */
+    uacpi_u64 p99_ticks;
+
+    // Time spent executing the AML handler, always 0 for native handlers
+    uacpi_u64 aml_avg_ticks;
+    uacpi_u64 aml_max_ticks;
+} uacpi_event_latency_stats;
+
+UACPI_ALWAYS_ERROR_FOR_REDUCED_HARDWARE(
+uacpi_status uacpi_fixed_event_stats(
+    uacpi_fixed_event event, uacpi_event_latency_stats *out_stats
+))
+
 UACPI_ALWAYS_ERROR_FOR_REDUCED_HARDWARE(
 uacpi_status uacpi_gpe_info(
    uacpi_namespace_node *gpe_devicem, uacpi_u16 idx,
    uacpi_event_info *out_info
 ))
 
+typedef struct uacpi_gpe_event_stats {
+    // Times the event was dispatched, whether by interrupt or by polling
+    uacpi_u32 fire_count;
+
+    /*
+     * Times the event fired often enough to be considered an interrupt storm.
+     * Its interrupt is then disabled and the status is polled until the event
+     * calms down, UACPI_EVENT_INFO_POLLING is set in uacpi_gpe_info() while
+     * this is the case.
+     */
+    uacpi_u32 storm_count;
+
+    uacpi_event_latency_stats latency;
+} uacpi_gpe_event_stats;
+
+UACPI_ALWAYS_ERROR_FOR_REDUCED_HARDWARE(
+uacpi_status uacpi_gpe_stats(
+   uacpi_namespace_node *gpe_device, uacpi_u16 idx,
+   uacpi_gpe_event_stats *out_stats
+))
+
 // Set if the handler wishes to reenable the GPE it just handled
 #define UACPI_GPE_REENABLE (1 << 7)
 
@@ -303,6 +357,22 @@ uacpi_status uacpi_uninstall_gpe_block(
     uacpi_namespace_node *gpe_device
 ))
 
+#define UACPI_SCI_LATENCY_BUCKETS 16
+
+/*
+ * Time spent handling each SCI, in the 100ns ticks of uacpi_kernel_get_ticks().
+ * Bucket 0 counts interrupts handled within the same tick, bucket N those that
+ * took [2^(N-1), 2^N) ticks, and the last bucket anything longer than that.
+ */
+typedef struct uacpi_sci_latency_stats {
+    uacpi_u64 buckets[UACPI_SCI_LATENCY_BUCKETS];
+    uacpi_u64 max_ticks;
+} uacpi_sci_latency_stats;
+
+UACPI_ALWAYS_ERROR_FOR_REDUCED_HARDWARE(
+uacpi_status uacpi_get_sci_latency_stats(uacpi_sci_latency_stats *out_stats)
+)
+
 #ifdef __cplusplus
 }
 #endif
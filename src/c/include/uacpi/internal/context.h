@@ -144,7 +144,7 @@ static inline uacpi_bool uacpi_check_flag(uacpi_u64 flag)
 
 static inline uacpi_bool uacpi_should_log(enum uacpi_log_level lvl)
 {
-    return lvl <= g_uacpi_rt_ctx.log_level;
+    return lvl <= UACPI_MAX_LOG_LEVEL && lvl <= g_uacpi_rt_ctx.log_level;
 }
 
 static inline uacpi_bool uacpi_is_hardware_reduced(void)
@@ -29,24 +29,66 @@
 #include <uacpi/internal/stdlib.h>
 #include <uacpi/kernel_api.h>
 
+/*
+ * An optional allocator the dynamic part of an array can be drawn from
+ * instead of the kernel heap, e.g. a per-evaluation arena. Must be attached
+ * via name##_set_allocator() before the array spills out of inline storage.
+ */
+struct uacpi_dynamic_array_allocator {
+    void *(*alloc)(void *ctx, uacpi_size size);
+    void (*free)(void *ctx, void *mem, uacpi_size size);
+    void *ctx;
+};
+
+static inline void *uacpi_dynamic_array_do_alloc(
+    struct uacpi_dynamic_array_allocator *allocator, uacpi_size size
+)
+{
+    if (allocator == UACPI_NULL)
+        return uacpi_kernel_alloc(size);
+
+    return allocator->alloc(allocator->ctx, size);
+}
+
+static inline void uacpi_dynamic_array_do_free(
+    struct uacpi_dynamic_array_allocator *allocator, void *mem, uacpi_size size
+)
+{
+    if (mem == UACPI_NULL)
+        return;
+
+    if (allocator == UACPI_NULL) {
+        uacpi_free(mem, size);
+        return;
+    }
+
+    allocator->free(allocator->ctx, mem, size);
+}
+
 #define DYNAMIC_ARRAY_WITH_INLINE_STORAGE(name, type, inline_capacity)       \
     struct name {                                                            \
         type inline_storage[inline_capacity];                                \
         type *dynamic_storage;                                               \
         uacpi_size dynamic_capacity;                                         \
         uacpi_size size_including_inline;                                    \
+        struct uacpi_dynamic_array_allocator *allocator;                     \
     };                                                                       \
 
 #define DYNAMIC_ARRAY_SIZE(arr) ((arr)->size_including_inline)
 
-#define DYNAMIC_ARRAY_WITH_INLINE_STORAGE_EXPORTS(name, type, prefix) \
-    prefix uacpi_size name##_inline_capacity(struct name *arr);       \
-    prefix type *name##_at(struct name *arr, uacpi_size idx);         \
-    prefix type *name##_alloc(struct name *arr);                      \
-    prefix type *name##_calloc(struct name *arr);                     \
-    prefix void name##_pop(struct name *arr);                         \
-    prefix uacpi_size name##_size(struct name *arr);                  \
-    prefix type *name##_last(struct name *arr)                        \
+#define DYNAMIC_ARRAY_WITH_INLINE_STORAGE_EXPORTS(name, type, prefix)        \
+    prefix uacpi_size name##_inline_capacity(struct name *arr);              \
+    prefix type *name##_at(struct name *arr, uacpi_size idx);                \
+    prefix type *name##_alloc(struct name *arr);                             \
+    prefix type *name##_calloc(struct name *arr);                            \
+    prefix void name##_pop(struct name *arr);                                \
+    prefix uacpi_size name##_size(struct name *arr);                         \
+    prefix type *name##_last(struct name *arr);                              \
+    prefix uacpi_bool name##_reserve(struct name *arr, uacpi_size capacity); \
+    prefix void name##_shrink_to_fit(struct name *arr);                      \
+    prefix void name##_set_allocator(                                        \
+        struct name *arr, struct uacpi_dynamic_array_allocator *allocator    \
+    );                                                                       \
     prefix void name##_clear(struct name *arr);
 
 #define DYNAMIC_ARRAY_WITH_INLINE_STORAGE_IMPL(name, type, prefix)           \
@@ -74,6 +116,51 @@
     }                                                                        \
                                                                              \
     UACPI_MAYBE_UNUSED                                                       \
+    static uacpi_size name##_dynamic_size(struct name *arr)                  \
+    {                                                                        \
+        uacpi_size inline_cap = name##_inline_capacity(arr);                 \
+                                                                             \
+        if (arr->size_including_inline <= inline_cap)                        \
+            return 0;                                                        \
+                                                                             \
+        return arr->size_including_inline - inline_cap;                      \
+    }                                                                        \
+                                                                             \
+    /*                                                                       \
+     * Move the dynamic part of the array into a buffer of exactly           \
+     * 'new_capacity' elements, which must be able to hold all of them.      \
+     */                                                                      \
+    UACPI_MAYBE_UNUSED                                                       \
+    static uacpi_bool name##_resize_dynamic(                                 \
+        struct name *arr, uacpi_size new_capacity                            \
+    )                                                                        \
+    {                                                                        \
+        uacpi_size type_size = sizeof(*arr->dynamic_storage);                \
+        void *new_buf = UACPI_NULL;                                          \
+                                                                             \
+        if (new_capacity != 0) {                                             \
+            new_buf = uacpi_dynamic_array_do_alloc(                          \
+                arr->allocator, new_capacity * type_size                     \
+            );                                                               \
+            if (uacpi_unlikely(new_buf == UACPI_NULL))                       \
+                return UACPI_FALSE;                                          \
+                                                                             \
+            if (arr->dynamic_storage) {                                      \
+                uacpi_memcpy(new_buf, arr->dynamic_storage,                  \
+                             name##_dynamic_size(arr) * type_size);          \
+            }                                                                \
+        }                                                                    \
+                                                                             \
+        uacpi_dynamic_array_do_free(                                         \
+            arr->allocator, arr->dynamic_storage,                            \
+            arr->dynamic_capacity * type_size                                \
+        );                                                                   \
+        arr->dynamic_storage = new_buf;                                      \
+        arr->dynamic_capacity = new_capacity;                                \
+        return UACPI_TRUE;                                                   \
+    }                                                                        \
+                                                                             \
+    UACPI_MAYBE_UNUSED                                                       \
     prefix type *name##_alloc(struct name *arr)                              \
     {                                                                        \
         uacpi_size inline_cap;                                               \
@@ -86,24 +173,18 @@
                                                                              \
             dynamic_size = arr->size_including_inline - inline_cap;          \
             if (dynamic_size == arr->dynamic_capacity) {                     \
-                uacpi_size bytes, type_size;                                 \
-                void *new_buf;                                               \
-                                                                             \
-                type_size = sizeof(*arr->dynamic_storage);                   \
-                bytes = arr->dynamic_capacity * type_size;                   \
-                bytes += type_size;                                          \
-                                                                             \
-                new_buf = uacpi_kernel_alloc(bytes);                         \
-                if (!new_buf)                                                \
-                    return NULL;                                             \
-                arr->dynamic_capacity = bytes / type_size;                   \
-                                                                             \
-                if (arr->dynamic_storage) {                                  \
-                    uacpi_memcpy(new_buf, arr->dynamic_storage,              \
-                                 dynamic_size * type_size);                  \
-                }                                                            \
-                uacpi_free(arr->dynamic_storage, dynamic_size * type_size);  \
-                arr->dynamic_storage = new_buf;                              \
+                uacpi_size new_capacity;                                     \
+                                                                             \
+                /*                                                           \
+                 * Grow geometrically so that pushing N elements costs       \
+                 * O(log N) reallocations instead of O(N).                   \
+                 */                                                          \
+                new_capacity = arr->dynamic_capacity * 2;                    \
+                if (new_capacity == 0)                                       \
+                    new_capacity = inline_cap;                               \
+                                                                             \
+                if (!name##_resize_dynamic(arr, new_capacity))               \
+                    return UACPI_NULL;                                       \
             }                                                                \
                                                                              \
             out_ptr = &arr->dynamic_storage[dynamic_size];                   \
@@ -151,10 +232,49 @@
         return name##_at(arr, arr->size_including_inline - 1);               \
     }                                                                        \
                                                                              \
+    /*                                                                       \
+     * Make sure at least 'capacity' elements (including inline storage)     \
+     * can be allocated without having to grow the array.                    \
+     */                                                                      \
+    UACPI_MAYBE_UNUSED                                                       \
+    prefix uacpi_bool name##_reserve(struct name *arr, uacpi_size capacity)  \
+    {                                                                        \
+        if (capacity <= name##_capacity(arr))                                \
+            return UACPI_TRUE;                                               \
+                                                                             \
+        return name##_resize_dynamic(                                        \
+            arr, capacity - name##_inline_capacity(arr)                      \
+        );                                                                   \
+    }                                                                        \
+                                                                             \
+    UACPI_MAYBE_UNUSED                                                       \
+    prefix void name##_shrink_to_fit(struct name *arr)                       \
+    {                                                                        \
+        uacpi_size dynamic_size = name##_dynamic_size(arr);                  \
+                                                                             \
+        if (dynamic_size == arr->dynamic_capacity)                           \
+            return;                                                          \
+                                                                             \
+        /* Failing to shrink is harmless, just keep the bigger buffer */     \
+        name##_resize_dynamic(arr, dynamic_size);                            \
+    }                                                                        \
+                                                                             \
+    UACPI_MAYBE_UNUSED                                                       \
+    prefix void name##_set_allocator(                                        \
+        struct name *arr, struct uacpi_dynamic_array_allocator *allocator    \
+    )                                                                        \
+    {                                                                        \
+        /* Can't switch allocators once memory was drawn from one */         \
+        if (uacpi_unlikely(arr->dynamic_storage != UACPI_NULL))              \
+            return;                                                          \
+                                                                             \
+        arr->allocator = allocator;                                          \
+    }                                                                        \
+                                                                             \
     prefix void name##_clear(struct name *arr)                               \
     {                                                                        \
-        uacpi_free(                                                          \
-            arr->dynamic_storage,                                            \
+        uacpi_dynamic_array_do_free(                                         \
+            arr->allocator, arr->dynamic_storage,                            \
             arr->dynamic_capacity * sizeof(*arr->dynamic_storage)            \
         );                                                                   \
         arr->size_including_inline = 0;                                      \
@@ -36,6 +36,24 @@ enum uacpi_table_load_cause {
     UACPI_TABLE_LOAD_CAUSE_HOST,
 };
 
+uacpi_status uacpi_initialize_interpreter(void);
+void uacpi_deinitialize_interpreter(void);
+
+/*
+ * Enter/exit the interpreter lock, which serializes all AML execution.
+ * Recursive for the thread that currently owns it.
+ */
+uacpi_status uacpi_interpreter_enter(void);
+void uacpi_interpreter_exit(void);
+
+/*
+ * Fully release the interpreter lock around a potentially long blocking
+ * operation if the calling thread owns it. The return value must be passed
+ * to uacpi_interpreter_resume() once the operation completes.
+ */
+uacpi_u32 uacpi_interpreter_suspend(void);
+void uacpi_interpreter_resume(uacpi_u32 depth);
+
 uacpi_status uacpi_execute_table(void*, enum uacpi_table_load_cause cause);
 uacpi_status uacpi_osi(uacpi_handle handle, uacpi_object *retval);
 
@@ -43,3 +61,5 @@ uacpi_status uacpi_execute_control_method(
     uacpi_namespace_node *scope, uacpi_control_method *method,
     const uacpi_args *args, uacpi_object **ret
 );
+
+void uacpi_method_decode_cache_free(uacpi_control_method *method);
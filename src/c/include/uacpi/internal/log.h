@@ -35,11 +35,58 @@ UACPI_PRINTF_DECL(2, 3)
 void uacpi_log(uacpi_log_level, const uacpi_char*, ...);
 #endif
 
+#ifndef UACPI_LOG_RATELIMIT_BURST
+    // Number of messages a call site may log back to back
+    #define UACPI_LOG_RATELIMIT_BURST 10
+#endif
+
+#ifndef UACPI_LOG_RATELIMIT_PERIOD_MS
+    // A call site regains one message every period
+    #define UACPI_LOG_RATELIMIT_PERIOD_MS 500
+#endif
+
+/*
+ * Token bucket of a single call site, packed into one word so that it can be
+ * updated from interrupt context without a lock. The low 16 bits are the
+ * tokens used, the next 16 the number of messages suppressed since one was
+ * last let through, and the upper 32 the time of the last refill in
+ * milliseconds. A zeroed bucket is full.
+ */
+typedef struct uacpi_log_ratelimit {
+    uacpi_u64 state;
+} uacpi_log_ratelimit;
+
+/*
+ * Take a token from the bucket, logging how many messages were suppressed if
+ * this one is let through after some were not.
+ */
+uacpi_bool uacpi_log_ratelimit_allow(
+    uacpi_log_ratelimit *rl, uacpi_log_level lvl
+);
+
 #define uacpi_log_lvl(lvl, ...) \
     do { if (uacpi_should_log(lvl)) uacpi_log(lvl, __VA_ARGS__); } while (0)
 
+/*
+ * Rate limited per call site before the message is formatted, for the WARN
+ * and INFO messages a misbehaving GPE or opregion can repeat from interrupt
+ * context. Errors and everything logged once at boot use the plain macros.
+ */
+#define uacpi_log_lvl_ratelimited(lvl, ...)                              \
+    do {                                                                 \
+        static uacpi_log_ratelimit uacpi_log_rl;                         \
+        if (uacpi_should_log(lvl) &&                                     \
+            uacpi_log_ratelimit_allow(&uacpi_log_rl, lvl))               \
+            uacpi_log(lvl, __VA_ARGS__);                                 \
+    } while (0)
+
 #define uacpi_debug(...) uacpi_log_lvl(UACPI_LOG_DEBUG, __VA_ARGS__)
 #define uacpi_trace(...) uacpi_log_lvl(UACPI_LOG_TRACE, __VA_ARGS__)
 #define uacpi_info(...)  uacpi_log_lvl(UACPI_LOG_INFO, __VA_ARGS__)
 #define uacpi_warn(...)  uacpi_log_lvl(UACPI_LOG_WARN, __VA_ARGS__)
 #define uacpi_error(...) uacpi_log_lvl(UACPI_LOG_ERROR, __VA_ARGS__)
+
+#define uacpi_info_ratelimited(...) \
+    uacpi_log_lvl_ratelimited(UACPI_LOG_INFO, __VA_ARGS__)
+#define uacpi_warn_ratelimited(...) \
+    uacpi_log_lvl_ratelimited(UACPI_LOG_WARN, __VA_ARGS__)
@@ -42,6 +42,17 @@
 
 #define UACPI_NAMESPACE_NODE_PREDEFINED (1u << 31)
 
+/*
+ * Number of children a node must have before lookups by name stop walking
+ * the peer list and go through a hashed index instead. The index is dropped
+ * again once the node falls below half of this value.
+ */
+#ifndef UACPI_NAMESPACE_CHILD_INDEX_THRESHOLD
+#define UACPI_NAMESPACE_CHILD_INDEX_THRESHOLD 16
+#endif
+
+struct uacpi_namespace_child_index;
+
 typedef struct uacpi_namespace_node {
     struct uacpi_shareable shareable;
     uacpi_object_name name;
@@ -50,6 +61,17 @@ typedef struct uacpi_namespace_node {
     struct uacpi_namespace_node *parent;
     struct uacpi_namespace_node *child;
     struct uacpi_namespace_node *next;
+
+    /*
+     * Optional, only present for nodes with a large number of children.
+     * Lookups fall back to the peer list if this is NULL.
+     */
+    struct uacpi_namespace_child_index *child_index;
+    uacpi_u32 child_count;
+
+    // Link in the list of nodes waiting for concurrent readers to leave
+    struct uacpi_namespace_node *retired_next;
+    uacpi_u32 retired_epoch;
 } uacpi_namespace_node;
 
 uacpi_status uacpi_initialize_namespace(void);
@@ -61,10 +83,25 @@ void uacpi_namespace_node_unref(uacpi_namespace_node *node);
 uacpi_status uacpi_node_install(uacpi_namespace_node *parent, uacpi_namespace_node *node);
 void uacpi_node_uninstall(uacpi_namespace_node *node);
 
+/*
+ * Unlike the public lookup functions this doesn't take a reference, so the
+ * caller must either be in a read-side critical section or hold the
+ * interpreter lock, since nodes are only ever uninstalled by AML.
+ */
 uacpi_namespace_node *uacpi_namespace_node_find_sub_node(
     uacpi_namespace_node *parent,
     uacpi_object_name name
 );
 
+/*
+ * Read-side critical section for code that walks the namespace without
+ * holding any other lock. Nodes reachable from inside the section are not
+ * freed until it ends, even if they get uninstalled concurrently. Sections
+ * may nest and never block. The value returned by the lock function must be
+ * passed to the matching unlock.
+ */
+uacpi_u32 uacpi_namespace_read_lock(void);
+void uacpi_namespace_read_unlock(uacpi_u32 token);
+
 uacpi_bool uacpi_namespace_node_is_dangling(uacpi_namespace_node *node);
 uacpi_bool uacpi_namespace_node_is_predefined(uacpi_namespace_node *node);
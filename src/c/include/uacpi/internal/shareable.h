@@ -35,6 +35,12 @@ void uacpi_make_shareable_bugged(uacpi_handle);
 uacpi_u32 uacpi_shareable_ref(uacpi_handle);
 uacpi_u32 uacpi_shareable_unref(uacpi_handle);
 
+/*
+ * Takes a reference unless the count has already dropped to zero, i.e. the
+ * shareable is about to be freed by whoever dropped the last reference.
+ */
+uacpi_bool uacpi_shareable_try_ref(uacpi_handle);
+
 void uacpi_shareable_unref_and_delete_if_last(
     uacpi_handle, void (*do_free)(uacpi_handle)
 );
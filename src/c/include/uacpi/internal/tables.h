@@ -51,6 +51,10 @@ struct uacpi_installed_table {
 #define UACPI_TABLE_INVALID (1 << 2)
     uacpi_u8 flags;
     uacpi_u8 origin;
+
+    // Index of the next installed table with the same signature
+#define UACPI_TABLE_INDEX_NONE 0xFFFFFFFF
+    uacpi_u32 next_same_signature;
 };
 
 uacpi_status uacpi_initialize_tables(void);
@@ -66,6 +66,9 @@ uacpi_object *uacpi_unwrap_internal_reference(uacpi_object *object);
 
 uacpi_bool uacpi_package_fill(uacpi_package *pkg, uacpi_size num_elements);
 
+uacpi_status uacpi_initialize_object_pool(void);
+void uacpi_deinitialize_object_pool(void);
+
 uacpi_mutex *uacpi_create_mutex(void);
 void uacpi_mutex_unref(uacpi_mutex*);
 
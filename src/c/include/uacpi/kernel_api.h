@@ -305,6 +305,23 @@ uacpi_status uacpi_kernel_schedule_work(
     uacpi_work_type, uacpi_work_handler, uacpi_handle ctx
 );
 
+#ifdef UACPI_KERNEL_DELAYED_WORK
+/*
+ * Schedules deferred work to run once at least 'delay_ms' milliseconds have
+ * passed, without occupying the work queue of its type while it waits.
+ * Might be invoked from an interrupt context.
+ *
+ * uacpi_kernel_wait_for_work_completion must also wait for delayed work that
+ * has been scheduled but hasn't run yet.
+ *
+ * Used to poll storming GPEs. Without it, every poll sleeps inside its
+ * UACPI_WORK_GPE_EXECUTION work item, holding up other GPE handlers.
+ */
+uacpi_status uacpi_kernel_schedule_delayed_work(
+    uacpi_work_type, uacpi_work_handler, uacpi_handle ctx, uacpi_u64 delay_ms
+);
+#endif
+
 /*
  * Blocks until all scheduled work is complete and the work queue becomes empty.
  */
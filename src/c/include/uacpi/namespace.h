@@ -58,6 +58,11 @@ uacpi_object_name uacpi_namespace_node_name(const uacpi_namespace_node *node);
 
 uacpi_size uacpi_namespace_node_depth(const uacpi_namespace_node *node);
 
+/*
+ * Returns a referenced node, which stays valid even if it gets uninstalled
+ * concurrently, or NULL if nothing was found. The reference must be dropped
+ * with uacpi_namespace_node_release() once the node is no longer needed.
+ */
 uacpi_namespace_node *uacpi_namespace_node_find(
     uacpi_namespace_node *parent,
     const uacpi_char *path
@@ -74,6 +79,8 @@ uacpi_namespace_node *uacpi_namespace_node_resolve_from_aml_namepath(
     const uacpi_char *path
 );
 
+void uacpi_namespace_node_release(uacpi_namespace_node *node);
+
 typedef enum uacpi_ns_iteration_decision {
     // Continue to the next child of this node
     UACPI_NS_ITERATION_DECISION_CONTINUE,
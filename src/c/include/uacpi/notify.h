@@ -46,6 +46,40 @@ uacpi_status uacpi_uninstall_notify_handler(
     uacpi_namespace_node *node, uacpi_notify_handler handler
 );
 
+typedef enum uacpi_notify_priority {
+    /*
+     * Thermal zones and processors are delivered with high priority,
+     * everything else with normal priority.
+     */
+    UACPI_NOTIFY_PRIORITY_DEFAULT = 0,
+
+    UACPI_NOTIFY_PRIORITY_HIGH,
+    UACPI_NOTIFY_PRIORITY_NORMAL,
+    UACPI_NOTIFY_PRIORITY_LOW,
+} uacpi_notify_priority;
+
+/*
+ * Set the priority Notify() requests for a device node are delivered with.
+ * Pending notifications of higher priority are always delivered first, e.g. a
+ * power button can be marked HIGH and a battery LOW so that the latter's
+ * periodic status updates never hold up the former.
+ *
+ * Passing UACPI_NOTIFY_PRIORITY_DEFAULT reverts the node to its default.
+ */
+uacpi_status uacpi_set_notify_priority(
+    uacpi_namespace_node *node, uacpi_notify_priority priority
+);
+
+typedef struct uacpi_notify_stats {
+    // Notifications queued for delivery
+    uacpi_u64 queued;
+
+    // Notifications dropped as identical to one still waiting for delivery
+    uacpi_u64 coalesced;
+} uacpi_notify_stats;
+
+void uacpi_notify_get_stats(uacpi_notify_stats *out_stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -124,9 +124,13 @@ UACPI_MAKE_MSVC_CMPXCHG(16, short, 16)
 #if UACPI_POINTER_SIZE == 4
 #define uacpi_atomic_load_ptr(ptr_to_ptr) uacpi_atomic_load32(ptr_to_ptr)
 #define uacpi_atomic_store_ptr(ptr_to_ptr, value) uacpi_atomic_store32(ptr_to_ptr, value)
+#define uacpi_atomic_cmpxchg_ptr(ptr_to_ptr, expected, desired) \
+    uacpi_atomic_cmpxchg32(ptr_to_ptr, expected, desired)
 #else
 #define uacpi_atomic_load_ptr(ptr_to_ptr) uacpi_atomic_load64(ptr_to_ptr)
 #define uacpi_atomic_store_ptr(ptr_to_ptr, value) uacpi_atomic_store64(ptr_to_ptr, value)
+#define uacpi_atomic_cmpxchg_ptr(ptr_to_ptr, expected, desired) \
+    uacpi_atomic_cmpxchg64(ptr_to_ptr, expected, desired)
 #endif
 
 #endif
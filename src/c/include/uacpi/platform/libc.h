@@ -41,6 +41,9 @@
  * - snprintf
  * - vsnprintf
  *
+ * On x86-64 with GCC-compatible compilers the mem* helpers already move a word
+ * at a time and use rep movsb/stosb when the CPU advertises ERMS/FSRM.
+ *
  * In case your platform happens to implement optimized verisons of the helpers
  * above, you are able to make uACPI use those instead by overriding them like so:
  *
@@ -97,11 +97,38 @@ uacpi_status uacpi_table_find(
 
 /*
  * Increment/decrement a table's reference count.
- * The table is unmapped when the reference count drops to 0.
+ * The table may be unmapped when the reference count drops to 0, see
+ * uacpi_table_mapping_cache_get_stats() below.
  */
 uacpi_status uacpi_table_ref(uacpi_table*);
 uacpi_status uacpi_table_unref(uacpi_table*);
 
+typedef struct uacpi_table_mapping_cache_stats {
+    /*
+     * References that reused a mapping kept around after the table's last
+     * reference was dropped, each one saves a map and an unmap call.
+     */
+    uacpi_u64 hits;
+
+    // References that had to map the table
+    uacpi_u64 misses;
+
+    // Mappings dropped to make room for a more recently used table
+    uacpi_u64 evictions;
+
+    // Number of unreferenced tables currently kept mapped
+    uacpi_u32 cached;
+} uacpi_table_mapping_cache_stats;
+
+/*
+ * Unreferenced physical tables stay mapped until UACPI_TABLE_MAPPING_CACHE_SIZE
+ * more recently used ones push them out, so a table that is looked up and
+ * dropped over and over is only mapped once.
+ */
+uacpi_status uacpi_table_mapping_cache_get_stats(
+    uacpi_table_mapping_cache_stats *out_stats
+);
+
 /*
  * Returns the pointer to a sanitized internal version of FADT.
  *
@@ -147,6 +174,44 @@ uacpi_status uacpi_set_table_installation_handler(
     uacpi_table_installation_handler handler
 );
 
+/*
+ * A firmware table whose checksum has been verified, identified by where it
+ * lives and the header fields that change along with its contents.
+ */
+typedef struct uacpi_verified_table {
+    uacpi_u64 phys_addr;
+    uacpi_u32 length;
+    uacpi_u32 oem_revision;
+    uacpi_u8 checksum;
+} uacpi_verified_table;
+
+/*
+ * Hand over the tables verified during a previous boot, e.g. kept around by
+ * the bootloader across a warm reboot. Firmware tables installed at the same
+ * address with a matching header are considered verified without summing
+ * them. Any other table is verified as usual on first use, or at install
+ * with proactive checksumming.
+ *
+ * Like the installation handler, this may be called before early table
+ * access is set up. The records are not copied and must stay valid for as
+ * long as tables may be installed, or until replaced with another call.
+ * Passing NULL drops the cache.
+ */
+uacpi_status uacpi_set_verified_table_cache(
+    const uacpi_verified_table *records, uacpi_size count
+);
+
+/*
+ * Collect the currently verified firmware tables, for handing back via
+ * uacpi_set_verified_table_cache() next boot. Up to 'capacity' records are
+ * written to 'out_records', 'out_count' is set to the number of verified
+ * tables even if that is more than 'capacity'.
+ */
+uacpi_status uacpi_table_get_verified(
+    uacpi_verified_table *out_records, uacpi_size capacity,
+    uacpi_size *out_count
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -342,6 +342,8 @@ typedef uacpi_status (*uacpi_native_call_handler)(
     uacpi_handle ctx, uacpi_object *retval
 );
 
+struct uacpi_method_decode_cache;
+
 typedef struct uacpi_control_method {
     struct uacpi_shareable shareable;
     union {
@@ -349,6 +351,9 @@ typedef struct uacpi_control_method {
         uacpi_native_call_handler handler;
     };
     uacpi_mutex *mutex;
+
+    // Lazily built by the interpreter on first execution, may be NULL
+    struct uacpi_method_decode_cache *decode_cache;
     uacpi_u32 size;
     uacpi_u8 sync_level : 4;
     uacpi_u8 args : 3;
@@ -501,6 +506,22 @@ typedef uacpi_interrupt_ret (*uacpi_interrupt_handler)(uacpi_handle);
 
 uacpi_object *uacpi_create_object(uacpi_object_type type);
 
+typedef struct uacpi_object_pool_stats {
+    // Allocations served from the pool
+    uacpi_u64 hits;
+
+    // Allocations that had to go to the kernel heap
+    uacpi_u64 misses;
+
+    // Frees that went back to the kernel heap because the pool was full
+    uacpi_u64 releases;
+
+    // Number of objects currently sitting in the pool
+    uacpi_u32 cached;
+} uacpi_object_pool_stats;
+
+void uacpi_object_pool_get_stats(uacpi_object_pool_stats *out_stats);
+
 void uacpi_object_ref(uacpi_object *obj);
 void uacpi_object_unref(uacpi_object *obj);
 
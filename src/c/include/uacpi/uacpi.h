@@ -183,6 +183,25 @@ UACPI_ALWAYS_ERROR_FOR_REDUCED_HARDWARE(
 uacpi_status uacpi_acquire_global_lock(uacpi_u16 timeout, uacpi_u32 *out_seq);
 uacpi_status uacpi_release_global_lock(uacpi_u32 seq);
 
+typedef struct uacpi_global_lock_stats {
+    // Acquired right away
+    uacpi_u64 uncontended;
+
+    // Acquired while spinning briefly on a contended lock
+    uacpi_u64 spun;
+
+    // Had to sleep until the previous owner released the lock
+    uacpi_u64 blocked;
+
+    // AML re-acquiring the lock it already owned, e.g. for nested field access
+    uacpi_u64 recursive;
+
+    // Waits for the firmware to release its side of the lock
+    uacpi_u64 firmware_waits;
+} uacpi_global_lock_stats;
+
+void uacpi_global_lock_get_stats(uacpi_global_lock_stats *out_stats);
+
 /*
  * Reset the global uACPI state by freeing all internally allocated data
  * structures & resetting any global variables. After this call, uACPI must be
@@ -27,7 +27,10 @@
 #ifndef ARC_UTIL_H
 #define ARC_UTIL_H
 
+#include "interface/klog.h"
+#include "interface/loglevel.h"
 #include "interface/printf.h"
+#include "interface/terminal.h"
 #include "lib/util.h"
 
 #include <inttypes.h>
@@ -41,22 +44,74 @@
 #define ARC_DEBUG_WARN_STR "[WARNING]"
 #define ARC_DEBUG_ERR_STR  "[ERROR]"
 
+// Subsystem whose log level applies, files define this before their includes
+#ifndef ARC_DEBUG_SUBSYSTEM
+#define ARC_DEBUG_SUBSYSTEM KERNEL
+#endif
+
+#define ARC_DEBUG_PASTE_(__a, __b) __a##__b
+#define ARC_DEBUG_PASTE(__a, __b) ARC_DEBUG_PASTE_(__a, __b)
+// Compile time check folds messages above the subsystem's ARC_LOG_LEVEL_* away
+#define ARC_DEBUG_ENABLED(__level__) \
+	(ARC_LOG_##__level__ <= ARC_DEBUG_PASTE(ARC_LOG_LEVEL_, ARC_DEBUG_SUBSYSTEM) && \
+	 ARC_LOG_##__level__ <= Arc_LogLevels[ARC_DEBUG_PASTE(ARC_LOG_SUBSYS_, ARC_DEBUG_SUBSYSTEM)])
+
 #define ARC_DEBUG(__level__, ...) ARC_DEBUG_##__level__(__VA_ARGS__)
-#define ARC_DEBUG_ERR(...)  printf(ARC_DEBUG_ERR_STR ARC_DEBUG_NAME_STR ARC_DEBUG_NAME_SEP_STR __VA_ARGS__);
+// Errors are flushed out right away, along with anything logged before them, as the caller might be about to hang
+#define ARC_DEBUG_ERR(...) \
+	do { \
+		klog_drain(); \
+		printf(ARC_DEBUG_ERR_STR ARC_DEBUG_NAME_STR ARC_DEBUG_NAME_SEP_STR __VA_ARGS__); \
+		term_flush(); \
+	} while (0)
+
+// Records the message into the binary log without formatting it, it is printed by the next klog_drain
+#define ARC_KLOG(__level__, ...) ARC_KLOG_##__level__(__VA_ARGS__)
+#define ARC_KLOG_ERR(...) \
+	do { \
+		klog_record(ARC_KLOG_LEVEL_ERR, ARC_DEBUG_NAME_STR, __VA_ARGS__); \
+	} while (0)
 
 #ifdef ARC_DEBUG_ENABLE
-#define ARC_DEBUG_INFO_STR "[INFO]"
-#define ARC_DEBUG_WARN_STR "[WARNING]"
-#define ARC_DEBUG_INFO(...) printf(ARC_DEBUG_INFO_STR ARC_DEBUG_NAME_STR ARC_DEBUG_NAME_SEP_STR __VA_ARGS__);
-#define ARC_DEBUG_WARN(...) printf(ARC_DEBUG_WARN_STR ARC_DEBUG_NAME_STR ARC_DEBUG_NAME_SEP_STR __VA_ARGS__);
+#define ARC_DEBUG_PRINT(__level__, ...) \
+	do { \
+		if (ARC_DEBUG_ENABLED(__level__)) { \
+			printf(ARC_DEBUG_##__level__##_STR ARC_DEBUG_NAME_STR ARC_DEBUG_NAME_SEP_STR __VA_ARGS__); \
+		} \
+	} while (0)
+// Each call site gets its own token bucket, for messages a device can repeat at runtime (GPEs, interrupts)
+#define ARC_DEBUG_LIMITED(__level__, ...) \
+	do { \
+		static struct ARC_LogRateLimit __limit = { 0 }; \
+		if (ARC_DEBUG_ENABLED(__level__) && loglevel_ratelimit(&__limit, ARC_DEBUG_NAME_STR)) { \
+			printf(ARC_DEBUG_##__level__##_STR ARC_DEBUG_NAME_STR ARC_DEBUG_NAME_SEP_STR __VA_ARGS__); \
+		} \
+	} while (0)
+#define ARC_DEBUG_INFO(...) ARC_DEBUG_PRINT(INFO, __VA_ARGS__)
+#define ARC_DEBUG_WARN(...) ARC_DEBUG_PRINT(WARN, __VA_ARGS__)
+#define ARC_DEBUG_INFO_LIMITED(...) ARC_DEBUG_LIMITED(INFO, __VA_ARGS__)
+#define ARC_DEBUG_WARN_LIMITED(...) ARC_DEBUG_LIMITED(WARN, __VA_ARGS__)
+#define ARC_KLOG_RECORD(__level__, ...) \
+	do { \
+		if (ARC_DEBUG_ENABLED(__level__)) { \
+			klog_record(ARC_KLOG_LEVEL_##__level__, ARC_DEBUG_NAME_STR, __VA_ARGS__); \
+		} \
+	} while (0)
+#define ARC_KLOG_INFO(...) ARC_KLOG_RECORD(INFO, __VA_ARGS__)
+#define ARC_KLOG_WARN(...) ARC_KLOG_RECORD(WARN, __VA_ARGS__)
 #else
-#define ARC_DEBUG_INFO(...) ;
-#define ARC_DEBUG_WARN(...) ;
+#define ARC_DEBUG_INFO(...) do { } while (0)
+#define ARC_DEBUG_WARN(...) do { } while (0)
+#define ARC_DEBUG_INFO_LIMITED(...) do { } while (0)
+#define ARC_DEBUG_WARN_LIMITED(...) do { } while (0)
+#define ARC_KLOG_INFO(...) do { } while (0)
+#define ARC_KLOG_WARN(...) do { } while (0)
 #endif // ARC_DEBUG_ENABLE
 
 
 #define STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)
 #define ASSERT(cond) if (!(cond)) {					\
+			term_set_sync(); \
 			printf("Assertion %s failed (%s:%d)\n", #cond, __FILE__, __LINE__); \
 			for (;;); \
 		     }
@@ -0,0 +1,212 @@
+/**
+ * @file boottime.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * A static ring of TSC timestamped boot phases. Nothing in here allocates,
+ * so phases can be recorded before the PMM and allocator are up.
+*/
+#include <interface/boottime.h>
+#include <interface/printf.h>
+#include <lib/util.h>
+#include <util.h>
+
+static struct ARC_BootTimeRecord boottime_ring[ARC_BOOTTIME_MAX_RECORDS] = { 0 };
+static struct ARC_BootTimeRecord *boottime_current = NULL;
+static uint32_t boottime_count = 0;
+static uint64_t boottime_origin = 0;
+static uint64_t boottime_hz = 0;
+static int boottime_hz_probed = 0;
+
+#ifdef ARC_TARGET_ARCH_X86_64
+static inline void boottime_cpuid(uint32_t leaf, uint32_t *a, uint32_t *b, uint32_t *c, uint32_t *d) {
+	__asm__ volatile("cpuid" : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d) : "a"(leaf), "c"(0));
+}
+#endif
+
+void boottime_begin(const char *name) {
+	uint64_t now = boottime_rdtsc();
+
+	if (boottime_count == 0) {
+		boottime_origin = now;
+	}
+
+	if (boottime_current != NULL) {
+		// Previous phase was never ended, close it off here
+		boottime_current->end = now;
+	}
+
+	boottime_current = &boottime_ring[boottime_count % ARC_BOOTTIME_MAX_RECORDS];
+	boottime_count++;
+
+	boottime_current->name = name;
+	boottime_current->start = now;
+	boottime_current->end = now;
+	boottime_current->status = 0;
+}
+
+void boottime_end(int status) {
+	if (boottime_current == NULL) {
+		return;
+	}
+
+	boottime_current->end = boottime_rdtsc();
+	boottime_current->status = status;
+	boottime_current = NULL;
+}
+
+int boottime_get_records(struct ARC_BootTimeRecord *records, int max) {
+	if (records == NULL || max <= 0) {
+		return 0;
+	}
+
+	uint32_t count = boottime_count;
+	uint32_t first = 0;
+
+	if (count > ARC_BOOTTIME_MAX_RECORDS) {
+		first = count - ARC_BOOTTIME_MAX_RECORDS;
+	}
+
+	int i = 0;
+	for (; first + i < count && i < max; i++) {
+		records[i] = boottime_ring[(first + i) % ARC_BOOTTIME_MAX_RECORDS];
+	}
+
+	return i;
+}
+
+uint64_t boottime_tsc_hz() {
+	if (boottime_hz_probed) {
+		return boottime_hz;
+	}
+
+	boottime_hz_probed = 1;
+
+#ifdef ARC_TARGET_ARCH_X86_64
+	uint32_t a, b, c, d;
+	boottime_cpuid(0, &a, &b, &c, &d);
+	uint32_t max_leaf = a;
+
+	if (max_leaf >= 0x15) {
+		// a = denominator, b = numerator, c = core crystal clock in Hz
+		boottime_cpuid(0x15, &a, &b, &c, &d);
+
+		if (a != 0 && b != 0 && c != 0) {
+			boottime_hz = ((uint64_t)c * b) / a;
+			return boottime_hz;
+		}
+	}
+
+	if (max_leaf >= 0x16) {
+		// a = processor base frequency in MHz
+		boottime_cpuid(0x16, &a, &b, &c, &d);
+		boottime_hz = (uint64_t)(a & 0xFFFF) * 1000000;
+	}
+#endif
+
+	return boottime_hz;
+}
+
+static uint64_t boottime_scale(uint64_t ticks, uint64_t hz) {
+	if (hz == 0) {
+		return ticks;
+	}
+
+	// Split to avoid overflowing ticks * 1000000
+	return (ticks / hz) * 1000000 + ((ticks % hz) * 1000000) / hz;
+}
+
+/**
+ * Format line i of the table into line
+ *
+ * Line -1 is the header, the rest are the records still in the ring.
+ *
+ * @return length of the line, or -1 if there is no such line.
+*/
+static int boottime_format_line(char *line, int i) {
+	uint64_t hz = boottime_tsc_hz();
+	uint32_t count = boottime_count;
+	uint32_t first = 0;
+
+	if (i < 0) {
+		return sprintf(line, "%-16s %14s %14s %8s\n", "phase", hz ? "start(us)" : "start(tsc)",
+			       hz ? "duration(us)" : "duration(tsc)", "status");
+	}
+
+	if (count > ARC_BOOTTIME_MAX_RECORDS) {
+		first = count - ARC_BOOTTIME_MAX_RECORDS;
+	}
+
+	if (first + i >= count) {
+		return -1;
+	}
+
+	struct ARC_BootTimeRecord *record = &boottime_ring[(first + i) % ARC_BOOTTIME_MAX_RECORDS];
+
+	return sprintf(line, "%-16.16s %14"PRIu64" %14"PRIu64" %8d\n", record->name,
+		       boottime_scale(record->start - boottime_origin, hz),
+		       boottime_scale(record->end - record->start, hz), record->status);
+}
+
+size_t boottime_read(void *buffer, size_t size, size_t offset) {
+	if (buffer == NULL) {
+		return 0;
+	}
+
+	char line[96];
+	size_t position = 0;
+	size_t copied = 0;
+
+	for (int i = -1; copied < size; i++) {
+		int length = boottime_format_line(line, i);
+
+		if (length < 0) {
+			break;
+		}
+
+		// Lines are visited in order, so offset + copied >= position once this is true
+		if (offset + copied < position + length) {
+			size_t from = offset + copied - position;
+			size_t count = position + length - (offset + copied);
+
+			if (count > size - copied) {
+				count = size - copied;
+			}
+
+			memcpy((uint8_t *)buffer + copied, line + from, count);
+			copied += count;
+		}
+
+		position += length;
+	}
+
+	return copied;
+}
+
+void boottime_print() {
+	char line[96];
+
+	for (int i = -1; boottime_format_line(line, i) >= 0; i++) {
+		printf("%s", line);
+	}
+}
@@ -0,0 +1,568 @@
+/**
+ * @file klog.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Per-CPU rings of binary log records. Writers claim a slot with a single
+ * atomic add and never wait, a slot's state is the sequence number of the
+ * record in it plus one, or zero while it is being written. Readers use the
+ * state to tell committed, unfinished and overwritten records apart, and
+ * only format a record once they have read it.
+*/
+#include <interface/klog.h>
+#include <interface/boottime.h>
+#include <interface/printf.h>
+#include <lib/util.h>
+#include <util.h>
+
+#include <stdarg.h>
+
+#define ARC_KLOG_RING_MASK (ARC_KLOG_RING_SIZE - 1)
+
+struct klog_slot {
+	uint64_t state;
+	struct ARC_KLogRecord record;
+};
+
+struct klog_ring {
+	uint64_t head __attribute__((aligned(64)));
+	struct klog_slot slots[ARC_KLOG_RING_SIZE] __attribute__((aligned(64)));
+};
+
+static struct klog_ring klog_rings[ARC_KLOG_MAX_CPUS] = { 0 };
+static struct ARC_KLogReader klog_console = { 0 };
+static uint8_t klog_draining = 0;
+
+#ifndef ARC_KLOG_CPU_ID
+static uint8_t klog_tsc_aux = 0;
+
+static inline uint32_t klog_cpu_id() {
+#ifdef ARC_TARGET_ARCH_X86_64
+	uint32_t a, b, c, d;
+
+	if (__atomic_load_n(&klog_tsc_aux, __ATOMIC_RELAXED)) {
+		// Index the arch code put into IA32_TSC_AUX, far cheaper than CPUID
+		__asm__ volatile("rdtscp" : "=a"(a), "=d"(d), "=c"(c));
+
+		return c & ARC_TSC_AUX_CPU_MASK;
+	}
+
+	// Initial APIC ID
+	__asm__ volatile("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(1), "c"(0));
+
+	return b >> 24;
+#else
+	return 0;
+#endif
+}
+#define ARC_KLOG_CPU_ID() klog_cpu_id()
+#endif
+
+void klog_use_tsc_aux() {
+#ifndef ARC_KLOG_CPU_ID
+	__atomic_store_n(&klog_tsc_aux, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+enum {
+	KLOG_ARG_NONE = 0,
+	KLOG_ARG_INT,
+	KLOG_ARG_LONG,
+	KLOG_ARG_PTR,
+	KLOG_ARG_STR,
+	KLOG_ARG_WRITEBACK,
+	KLOG_ARG_UNKNOWN,
+};
+
+struct klog_spec {
+	/// Start of the flags, just after the %
+	const char *flags;
+	/// Length of the flags, width and precision
+	int flags_length;
+	/// Length modifier, only kept for int sized arguments
+	const char *length;
+	int length_length;
+	char conversion;
+	int class;
+	/// Number of * in the width and precision, each takes an int argument
+	int stars;
+	/// Precision, -1 if there is none or it is taken from the last * argument
+	int precision;
+	/// Whether the precision is a *
+	int precision_star;
+};
+
+/**
+ * Parse a conversion specification
+ *
+ * @param const char *format - Points just after the %.
+ * @param struct klog_spec *spec - Where to put the result.
+ * @return pointer just after the specification.
+*/
+static const char *klog_parse_spec(const char *format, struct klog_spec *spec) {
+	memset(spec, 0, sizeof(*spec));
+	spec->flags = format;
+	spec->precision = -1;
+
+	int in_precision = 0;
+
+	while (*format != 0 && strchr("-+ #0123456789.*", *format) != NULL) {
+		if (*format == '.') {
+			in_precision = 1;
+			spec->precision = 0;
+		} else if (in_precision && *format == '*') {
+			spec->precision = -1;
+			spec->precision_star = 1;
+		} else if (in_precision && *format >= '0' && *format <= '9') {
+			spec->precision = spec->precision * 10 + (*format - '0');
+		}
+
+		spec->stars += *format == '*';
+		format++;
+	}
+
+	spec->flags_length = format - spec->flags;
+	spec->length = format;
+
+	while (*format != 0 && strchr("hlzjtL", *format) != NULL) {
+		format++;
+	}
+
+	spec->length_length = format - spec->length;
+	spec->conversion = *format;
+
+	int wide = spec->length_length > 0 && *spec->length != 'h';
+
+	switch (spec->conversion) {
+		case '%': {
+			spec->class = KLOG_ARG_NONE;
+			break;
+		}
+
+		case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'b': case 'c': {
+			spec->class = wide ? KLOG_ARG_LONG : KLOG_ARG_INT;
+			break;
+		}
+
+		case 'p': {
+			spec->class = KLOG_ARG_PTR;
+			break;
+		}
+
+		case 's': {
+			spec->class = KLOG_ARG_STR;
+			break;
+		}
+
+		case 'n': {
+			spec->class = KLOG_ARG_WRITEBACK;
+			break;
+		}
+
+		default: {
+			// Includes floating point, which printf is built without
+			spec->class = KLOG_ARG_UNKNOWN;
+			return format;
+		}
+	}
+
+	return format + 1;
+}
+
+int klog_record(int level, const char *site, const char *format, ...) {
+	if (format == NULL) {
+		return -1;
+	}
+
+	uint32_t cpu = ARC_KLOG_CPU_ID();
+	struct klog_ring *ring = &klog_rings[cpu % ARC_KLOG_MAX_CPUS];
+	uint64_t sequence = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+	struct klog_slot *slot = &ring->slots[sequence & ARC_KLOG_RING_MASK];
+	struct ARC_KLogRecord *record = &slot->record;
+
+	// Invalidate the slot before touching it, so a reader can not mistake a half written record for the old one
+	__atomic_store_n(&slot->state, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	record->timestamp = boottime_rdtsc();
+	record->site = site;
+	record->format = format;
+	record->cpu = cpu;
+	record->level = level;
+	record->argc = 0;
+	record->strings[ARC_KLOG_STRING_SPACE - 1] = 0;
+
+	va_list args;
+	va_start(args, format);
+
+	size_t used = 0;
+	const char *f = format;
+
+	while (*f != 0 && record->argc < ARC_KLOG_MAX_ARGS) {
+		if (*f++ != '%') {
+			continue;
+		}
+
+		struct klog_spec spec;
+		f = klog_parse_spec(f, &spec);
+
+		if (spec.class == KLOG_ARG_UNKNOWN) {
+			// The type of the argument is unknown, so nothing after it can be read
+			break;
+		}
+
+		for (int i = 0; i < spec.stars && record->argc < ARC_KLOG_MAX_ARGS; i++) {
+			int value = va_arg(args, int);
+			record->args[record->argc++] = (uint64_t)(int64_t)value;
+
+			if (spec.precision_star && i == spec.stars - 1 && value >= 0) {
+				spec.precision = value;
+			}
+		}
+
+		if (record->argc >= ARC_KLOG_MAX_ARGS) {
+			break;
+		}
+
+		switch (spec.class) {
+			case KLOG_ARG_INT: {
+				record->args[record->argc++] = (uint64_t)(int64_t)va_arg(args, int);
+				break;
+			}
+
+			case KLOG_ARG_LONG: {
+				record->args[record->argc++] = (uint64_t)va_arg(args, long long);
+				break;
+			}
+
+			case KLOG_ARG_PTR: {
+				record->args[record->argc++] = (uintptr_t)va_arg(args, void *);
+				break;
+			}
+
+			case KLOG_ARG_STR: {
+				// Strings may not outlive the call, so they are copied, truncated if need be
+				const char *string = va_arg(args, const char *);
+				string = string == NULL ? "(null)" : string;
+				record->args[record->argc++] = used;
+
+				// A precision bounds the read, the string need not be terminated (%.4s on ACPI names)
+				for (int i = 0; (spec.precision < 0 || i < spec.precision) && string[i] != 0
+				     && used < ARC_KLOG_STRING_SPACE - 1; i++) {
+					record->strings[used++] = string[i];
+				}
+
+				if (used < ARC_KLOG_STRING_SPACE - 1) {
+					record->strings[used++] = 0;
+				}
+
+				break;
+			}
+
+			case KLOG_ARG_WRITEBACK: {
+				(void)va_arg(args, void *);
+				break;
+			}
+		}
+	}
+
+	va_end(args);
+
+	__atomic_store_n(&slot->state, sequence + 1, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+void klog_reader_init(struct ARC_KLogReader *reader) {
+	if (reader == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < ARC_KLOG_MAX_CPUS; i++) {
+		uint64_t head = __atomic_load_n(&klog_rings[i].head, __ATOMIC_ACQUIRE);
+		reader->tail[i] = head > ARC_KLOG_RING_SIZE ? head - ARC_KLOG_RING_SIZE : 0;
+	}
+
+	reader->dropped = 0;
+}
+
+/**
+ * Copy out the next record of a ring
+ *
+ * Skips over records that have been overwritten, counting them
+ * as dropped.
+ *
+ * @param struct ARC_KLogReader *reader - Reader to read with.
+ * @param int cpu - Ring to read from.
+ * @param struct ARC_KLogRecord *record - Where to copy the record.
+ * @param int full - Whether to copy the whole record or only its timestamp.
+ * @return zero if a record was copied, -1 if the next record is not ready.
+*/
+static int klog_peek(struct ARC_KLogReader *reader, int cpu, struct ARC_KLogRecord *record, int full) {
+	struct klog_ring *ring = &klog_rings[cpu];
+
+	for (;;) {
+		uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		uint64_t tail = reader->tail[cpu];
+
+		if (tail >= head) {
+			return -1;
+		}
+
+		if (head - tail > ARC_KLOG_RING_SIZE) {
+			reader->dropped += head - ARC_KLOG_RING_SIZE - tail;
+			reader->tail[cpu] = tail = head - ARC_KLOG_RING_SIZE;
+		}
+
+		struct klog_slot *slot = &ring->slots[tail & ARC_KLOG_RING_MASK];
+		uint64_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+
+		if (state > tail + 1) {
+			// Lapped since head was read
+			reader->dropped++;
+			reader->tail[cpu]++;
+			continue;
+		}
+
+		if (state != tail + 1) {
+			// Still being written
+			return -1;
+		}
+
+		if (full) {
+			memcpy(record, &slot->record, sizeof(*record));
+		} else {
+			record->timestamp = slot->record.timestamp;
+		}
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(&slot->state, __ATOMIC_RELAXED) == state) {
+			return 0;
+		}
+	}
+}
+
+static void klog_append(size_t size, size_t *position, int length) {
+	if (length > 0) {
+		*position += length;
+	}
+
+	if (*position >= size) {
+		*position = size - 1;
+	}
+}
+
+static size_t klog_format(struct ARC_KLogRecord *record, char *buffer, size_t size) {
+	static const char *levels[] = {
+		[ARC_KLOG_LEVEL_ERR] = ARC_DEBUG_ERR_STR,
+		[ARC_KLOG_LEVEL_WARN] = ARC_DEBUG_WARN_STR,
+		[ARC_KLOG_LEVEL_INFO] = ARC_DEBUG_INFO_STR,
+	};
+	uint64_t hz = boottime_tsc_hz();
+	size_t position = 0;
+	int length = 0;
+
+	if (hz != 0) {
+		uint64_t us = (record->timestamp % hz) * 1000000 / hz;
+		length = snprintf_(buffer, size, "[%5"PRIu64".%06"PRIu64"] ", record->timestamp / hz, us);
+	} else {
+		length = snprintf_(buffer, size, "[%"PRIu64"] ", record->timestamp);
+	}
+
+	klog_append(size, &position, length);
+
+	const char *level = record->level <= ARC_KLOG_LEVEL_INFO ? levels[record->level] : NULL;
+	level = level == NULL ? "" : level;
+	length = snprintf_(buffer + position, size - position, "[CPU %d] %s%s" ARC_DEBUG_NAME_SEP_STR, record->cpu, level,
+			   record->site == NULL ? "" : record->site);
+	klog_append(size, &position, length);
+
+	const char *f = record->format;
+	int arg = 0;
+
+	while (*f != 0 && position < size - 1) {
+		if (*f != '%') {
+			buffer[position++] = *f++;
+			continue;
+		}
+
+		const char *start = f++;
+		struct klog_spec spec;
+		f = klog_parse_spec(f, &spec);
+
+		if (spec.class == KLOG_ARG_NONE) {
+			buffer[position++] = '%';
+			continue;
+		}
+
+		if (spec.class == KLOG_ARG_WRITEBACK) {
+			continue;
+		}
+
+		// Rebuild the specification with * filled in, and a length matching what was recorded
+		char conversion[48];
+		int at = 0;
+		int missing = spec.class == KLOG_ARG_UNKNOWN;
+
+		conversion[at++] = '%';
+
+		for (int i = 0; i < spec.flags_length && at < 20; i++) {
+			if (spec.flags[i] != '*') {
+				conversion[at++] = spec.flags[i];
+				continue;
+			}
+
+			if (arg >= record->argc) {
+				missing = 1;
+				break;
+			}
+
+			at += snprintf_(conversion + at, sizeof(conversion) - at, "%d", (int)record->args[arg++]);
+		}
+
+		if (spec.class == KLOG_ARG_INT) {
+			for (int i = 0; i < spec.length_length && i < 2; i++) {
+				conversion[at++] = spec.length[i];
+			}
+		} else if (spec.class == KLOG_ARG_LONG) {
+			conversion[at++] = 'l';
+			conversion[at++] = 'l';
+		}
+
+		conversion[at++] = spec.conversion;
+		conversion[at] = 0;
+
+		if (missing || arg >= record->argc) {
+			// Dropped or unknown argument, print the specification itself
+			size_t count = spec.class == KLOG_ARG_UNKNOWN ? strlen(start) : (size_t)(f - start);
+			count = count > size - 1 - position ? size - 1 - position : count;
+			memcpy(buffer + position, start, count);
+			position += count;
+
+			if (spec.class == KLOG_ARG_UNKNOWN) {
+				break;
+			}
+
+			continue;
+		}
+
+		uint64_t value = record->args[arg++];
+
+		switch (spec.class) {
+			case KLOG_ARG_INT: {
+				length = snprintf_(buffer + position, size - position, conversion, (int)value);
+				break;
+			}
+
+			case KLOG_ARG_LONG: {
+				length = snprintf_(buffer + position, size - position, conversion, (long long)value);
+				break;
+			}
+
+			case KLOG_ARG_PTR: {
+				length = snprintf_(buffer + position, size - position, conversion, (void *)(uintptr_t)value);
+				break;
+			}
+
+			case KLOG_ARG_STR: {
+				const char *string = value < ARC_KLOG_STRING_SPACE ? record->strings + value : "";
+				length = snprintf_(buffer + position, size - position, conversion, string);
+				break;
+			}
+		}
+
+		klog_append(size, &position, length);
+	}
+
+	// Every read returns a whole line
+	if (position > 0 && buffer[position - 1] != '\n') {
+		if (position == size - 1) {
+			position--;
+		}
+
+		buffer[position++] = '\n';
+	}
+
+	buffer[position] = 0;
+
+	return position;
+}
+
+size_t klog_read(struct ARC_KLogReader *reader, char *buffer, size_t size) {
+	if (reader == NULL || buffer == NULL || size < 2) {
+		return 0;
+	}
+
+	struct ARC_KLogRecord record;
+
+	for (;;) {
+		int oldest = -1;
+		uint64_t timestamp = 0;
+
+		for (int i = 0; i < ARC_KLOG_MAX_CPUS; i++) {
+			if (klog_peek(reader, i, &record, 0) != 0) {
+				continue;
+			}
+
+			if (oldest < 0 || record.timestamp < timestamp) {
+				oldest = i;
+				timestamp = record.timestamp;
+			}
+		}
+
+		if (reader->dropped > 0) {
+			size_t length = snprintf_(buffer, size, "[klog] %"PRIu64" records dropped\n", reader->dropped);
+			reader->dropped = 0;
+
+			return length >= size ? size - 1 : length;
+		}
+
+		if (oldest < 0) {
+			return 0;
+		}
+
+		if (klog_peek(reader, oldest, &record, 1) != 0) {
+			// Overwritten since it was picked
+			continue;
+		}
+
+		reader->tail[oldest]++;
+
+		return klog_format(&record, buffer, size);
+	}
+}
+
+void klog_drain() {
+	if (__atomic_test_and_set(&klog_draining, __ATOMIC_ACQUIRE)) {
+		return;
+	}
+
+	char line[256];
+
+	while (klog_read(&klog_console, line, sizeof(line)) > 0) {
+		printf("%s", line);
+	}
+
+	__atomic_clear(&klog_draining, __ATOMIC_RELEASE);
+}
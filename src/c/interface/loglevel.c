@@ -0,0 +1,120 @@
+/**
+ * @file loglevel.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Runtime log levels and the token buckets ARC_DEBUG rate limits call
+ * sites with.
+*/
+#define ARC_DEBUG_SUBSYSTEM INTERFACE
+
+#include <interface/loglevel.h>
+#include <interface/boottime.h>
+#include <interface/printf.h>
+#include <util.h>
+
+/// TSC frequency assumed if the real one can not be determined
+#define ARC_LOG_FALLBACK_TSC_HZ 1000000000ULL
+
+#define ARC_LOG_RL_USED(__state) ((__state) & 0xFFFF)
+#define ARC_LOG_RL_SUPPRESSED(__state) (((__state) >> 16) & 0xFFFF)
+#define ARC_LOG_RL_TIME(__state) ((uint32_t)((__state) >> 32))
+#define ARC_LOG_RL_STATE(__used, __suppressed, __time) \
+	((uint64_t)(__used) | ((uint64_t)(__suppressed) << 16) | ((uint64_t)(__time) << 32))
+
+uint8_t Arc_LogLevels[ARC_LOG_SUBSYS_COUNT] = {
+	[ARC_LOG_SUBSYS_KERNEL] = ARC_LOG_LEVEL_KERNEL,
+	[ARC_LOG_SUBSYS_INTERFACE] = ARC_LOG_LEVEL_INTERFACE,
+	[ARC_LOG_SUBSYS_MM] = ARC_LOG_LEVEL_MM,
+	[ARC_LOG_SUBSYS_FS] = ARC_LOG_LEVEL_FS,
+	[ARC_LOG_SUBSYS_MP] = ARC_LOG_LEVEL_MP,
+	[ARC_LOG_SUBSYS_ARCH] = ARC_LOG_LEVEL_ARCH,
+	[ARC_LOG_SUBSYS_ACPI] = ARC_LOG_LEVEL_ACPI,
+	[ARC_LOG_SUBSYS_DRIVERS] = ARC_LOG_LEVEL_DRIVERS,
+	[ARC_LOG_SUBSYS_USERSPACE] = ARC_LOG_LEVEL_USERSPACE,
+};
+
+int loglevel_set(int subsystem, int level) {
+	if (subsystem < 0 || subsystem >= ARC_LOG_SUBSYS_COUNT || level < ARC_LOG_ERR || level > ARC_LOG_INFO) {
+		return -1;
+	}
+
+	__atomic_store_n(&Arc_LogLevels[subsystem], level, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+int loglevel_get(int subsystem) {
+	if (subsystem < 0 || subsystem >= ARC_LOG_SUBSYS_COUNT) {
+		return -1;
+	}
+
+	return __atomic_load_n(&Arc_LogLevels[subsystem], __ATOMIC_RELAXED);
+}
+
+static uint32_t loglevel_now_ms() {
+	uint64_t hz = boottime_tsc_hz();
+
+	if (hz == 0) {
+		hz = ARC_LOG_FALLBACK_TSC_HZ;
+	}
+
+	return (uint32_t)(boottime_rdtsc() / (hz / 1000));
+}
+
+int loglevel_ratelimit(struct ARC_LogRateLimit *limit, const char *site) {
+	uint32_t now = loglevel_now_ms();
+	uint64_t state = __atomic_load_n(&limit->state, __ATOMIC_RELAXED);
+	uint64_t next = 0;
+	uint32_t suppressed = 0;
+	int pass = 0;
+
+	do {
+		uint32_t used = ARC_LOG_RL_USED(state);
+		uint32_t time = ARC_LOG_RL_TIME(state);
+		uint32_t refill = (now - time) / ARC_LOG_RATELIMIT_PERIOD_MS;
+
+		if (refill >= used) {
+			used = 0;
+			time = now;
+		} else {
+			used -= refill;
+			time += refill * ARC_LOG_RATELIMIT_PERIOD_MS;
+		}
+
+		suppressed = ARC_LOG_RL_SUPPRESSED(state);
+		pass = used < ARC_LOG_RATELIMIT_BURST;
+
+		if (pass) {
+			next = ARC_LOG_RL_STATE(used + 1, 0, time);
+		} else {
+			next = ARC_LOG_RL_STATE(used, suppressed < 0xFFFF ? suppressed + 1 : suppressed, time);
+		}
+	} while (!__atomic_compare_exchange_n(&limit->state, &state, next, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	if (pass && suppressed > 0) {
+		printf(ARC_DEBUG_WARN_STR "%s" ARC_DEBUG_NAME_SEP_STR "%d messages suppressed\n", site, suppressed);
+	}
+
+	return pass;
+}
@@ -26,6 +26,8 @@
  * A basic terminal implementation capable of displaying to a framebuffer and
  * sending written data through a COM port specified at compile time.
 */
+#define ARC_DEBUG_SUBSYSTEM INTERFACE
+
 #include <fs/vfs.h>
 #include <mm/allocator.h>
 #include <global.h>
@@ -45,20 +47,255 @@ static int term_width = 0;
 static int term_height = 0;
 uint8_t term_mem[0x4000] = { 0 };
 
-void term_putchar(char c) {
+/*
+ * Text is kept in a ring of term_lines lines, screen row y is line
+ * (term_top + y) % term_lines and the term_history lines before it are
+ * scrollback. The ring lives in term_mem until init_terminal_scrollback.
+*/
+static uint8_t *term_buffer = term_mem;
+static int term_lines = 0;
+static int term_top = 0;
+static int term_history = 0;
+/// Number of lines of scrollback requested through init_terminal_scrollback
+static int term_scrollback = 0;
+
+/// Get line y of the screen, negative lines are scrollback
+static inline uint8_t *term_line(int y) {
+	return term_buffer + ((term_top + y + term_lines) % term_lines) * term_width;
+}
+
+#define ARC_TERM_ROM_WIDTH 8
+#define ARC_TERM_ROM_HEIGHT 8
+#define ARC_TERM_MAX_ROWS 1024
+
+/// Size of the cells the terminal is laid out in, the font size times its scale
+static int term_cell_width = ARC_TERM_ROM_WIDTH;
+static int term_cell_height = ARC_TERM_ROM_HEIGHT;
+
+/*
+ * Damage tracking, term_draw only re-renders cells in [lo, hi) of each row
+ * and catches up with scrolling by moving the already rendered lines.
+*/
+static uint16_t term_dirty_lo[ARC_TERM_MAX_ROWS] = { 0 };
+static uint16_t term_dirty_hi[ARC_TERM_MAX_ROWS] = { 0 };
+static int term_scrolled = 0;
+static int term_redraw_all = 1;
+static uint64_t term_fb_written = 0;
+
+static inline void term_damage(int x, int y, int count) {
+	if (y < 0 || y >= term_height || x >= term_width) {
+		return;
+	}
+
+	int hi = x + count > term_width ? term_width : x + count;
+
+	if (term_dirty_lo[y] >= term_dirty_hi[y]) {
+		term_dirty_lo[y] = x;
+		term_dirty_hi[y] = hi;
+		return;
+	}
+
+	if (x < term_dirty_lo[y]) {
+		term_dirty_lo[y] = x;
+	}
+
+	if (hi > term_dirty_hi[y]) {
+		term_dirty_hi[y] = hi;
+	}
+}
+
+#ifdef ARC_COM_PORT
+/*
+ * Serial output is queued in a lock-free multi-producer ring and pushed out to
+ * the UART in batches by whoever manages to claim term_com_draining, so that
+ * callers never have to wait on the line-status register unless the ring is
+ * full or output has been made synchronous.
+ *
+ * Producers only drain as far as the UART lets them without waiting, so the
+ * tail of a burst stays queued until someone calls term_flush(). kernel_main
+ * does so once it's done booting and every time its idle loop wakes up.
+ *
+ * term_com_draining is only ever held with interrupts disabled, and only for
+ * one FIFO's worth of bytes. An interrupt handler that has to wait for the
+ * drain (ARC_DEBUG_ERR, a full ring) therefore can not have interrupted the
+ * holder on its own processor.
+*/
+#define ARC_TERM_COM_RING_MASK (ARC_TERM_COM_RING_SIZE - 1)
+
+STATIC_ASSERT((ARC_TERM_COM_RING_SIZE & ARC_TERM_COM_RING_MASK) == 0, "COM ring size must be a power of two");
+
+static char term_com_ring[ARC_TERM_COM_RING_SIZE] = { 0 };
+// Set once the byte in the corresponding ring slot has been written
+static uint8_t term_com_ready[ARC_TERM_COM_RING_SIZE] = { 0 };
+static uint64_t term_com_head = 0;
+static uint64_t term_com_tail = 0;
+static uint8_t term_com_draining = 0;
+static int term_com_sync = 0;
+// Bytes that can be written per THRE, 1 until init_terminal enables the FIFO
+static int term_com_batch = 1;
+
+static inline int term_com_tx_empty() {
+	return MASKED_READ(inb(ARC_COM_PORT + 5), 5, 1);
+}
+
+/// Disable interrupts, returns the previous flags for term_com_irq_restore
+static inline uint64_t term_com_irq_save() {
+#ifdef ARC_TARGET_ARCH_X86_64
+	uint64_t flags = 0;
+	__asm__ volatile("pushfq; pop %0; cli" : "=r"(flags) :: "memory");
+
+	return flags;
+#else
+	return 0;
+#endif
+}
+
+static inline void term_com_irq_restore(uint64_t flags) {
+#ifdef ARC_TARGET_ARCH_X86_64
+	// IF
+	if (flags & (1 << 9)) {
+		__asm__ volatile("sti" ::: "memory");
+	}
+#else
+	(void)flags;
+#endif
+}
+
+/**
+ * Push queued bytes out to the UART
+ *
+ * @param int wait - Busy-poll the UART until the ring is empty, otherwise
+ * return as soon as the UART is busy or someone else is already draining.
+*/
+static void term_com_drain(int wait) {
+	for (;;) {
+		uint64_t flags = term_com_irq_save();
+
+		if (__atomic_test_and_set(&term_com_draining, __ATOMIC_ACQUIRE)) {
+			// Held by another processor, it can not be this one with interrupts off
+			term_com_irq_restore(flags);
+
+			if (!wait) {
+				return;
+			}
+
+			continue;
+		}
+
+		for (;;) {
+			uint64_t tail = term_com_tail;
+
+			if (__atomic_load_n(&term_com_ready[tail & ARC_TERM_COM_RING_MASK], __ATOMIC_ACQUIRE) == 0) {
+				break;
+			}
+
+			if (!term_com_tx_empty()) {
+				// Wait for the UART without holding the drain, or interrupts off
+				break;
+			}
+
+			// The transmitter is empty, so the whole FIFO can be filled at once
+			for (int i = 0; i < term_com_batch; i++) {
+				uint64_t slot = tail & ARC_TERM_COM_RING_MASK;
+
+				if (__atomic_load_n(&term_com_ready[slot], __ATOMIC_ACQUIRE) == 0) {
+					break;
+				}
+
+				outb(ARC_COM_PORT, term_com_ring[slot]);
+				__atomic_store_n(&term_com_ready[slot], 0, __ATOMIC_RELAXED);
+				tail++;
+			}
+
+			__atomic_store_n(&term_com_tail, tail, __ATOMIC_RELEASE);
+		}
+
+		__atomic_clear(&term_com_draining, __ATOMIC_RELEASE);
+		term_com_irq_restore(flags);
+
+		/*
+		 * A producer may have published a byte and failed to claim the
+		 * drain while we were on our way out, pick it up if the UART can
+		 * take it right now. When waiting, this is also where the UART is
+		 * polled until it has room for the next batch.
+		*/
+		uint64_t tail = __atomic_load_n(&term_com_tail, __ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&term_com_ready[tail & ARC_TERM_COM_RING_MASK], __ATOMIC_ACQUIRE) == 0
+		    || (!wait && !term_com_tx_empty())) {
+			return;
+		}
+	}
+}
+
+static void term_com_putchar(char c) {
+	if (term_com_sync) {
+		term_com_drain(1);
+
+		while (!term_com_tx_empty());
+		outb(ARC_COM_PORT, c);
+
+		return;
+	}
+
+	uint64_t head = __atomic_load_n(&term_com_head, __ATOMIC_RELAXED);
+
+	for (;;) {
+		if (head - __atomic_load_n(&term_com_tail, __ATOMIC_ACQUIRE) >= ARC_TERM_COM_RING_SIZE) {
+			// Full, make room by waiting on the UART
+			term_com_drain(1);
+			head = __atomic_load_n(&term_com_head, __ATOMIC_RELAXED);
+			continue;
+		}
+
+		if (__atomic_compare_exchange_n(&term_com_head, &head, head + 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	term_com_ring[head & ARC_TERM_COM_RING_MASK] = c;
+	__atomic_store_n(&term_com_ready[head & ARC_TERM_COM_RING_MASK], 1, __ATOMIC_RELEASE);
+
+	term_com_drain(0);
+}
+#endif
+
+void term_flush() {
 #ifdef ARC_COM_PORT
-        uint8_t lsr = inb(ARC_COM_PORT + 5);
-        while (MASKED_READ(lsr, 5, 1) == 0) {
-                lsr = inb(ARC_COM_PORT + 5);
-        }
+	term_com_drain(1);
+#endif
+}
 
-        outb(ARC_COM_PORT, c);
+void term_set_sync() {
+#ifdef ARC_COM_PORT
+	term_com_sync = 1;
+	term_com_drain(1);
 #endif
+}
+
+void term_putchar(char c) {
+#ifdef ARC_COM_PORT
+	term_com_putchar(c);
+#endif
+
+	if (term_lines == 0) {
+		// Not initialized yet, the character only goes out through the COM port
+		return;
+	}
 
 	if (term_y >= term_height) {
-		memcpy(term_mem, term_mem + term_width, (term_height - 1) * term_width);
-		memset(term_mem + (term_height - 1) * term_width, 0, term_width);
+		// The top line of the screen becomes history, the oldest line is reused once the ring is full
+		term_top = (term_top + 1) % term_lines;
+		term_history += term_history < term_lines - term_height;
+		memset(term_line(term_height - 1), 0, term_width);
 		term_y = term_height - 1;
+
+		// Damage moves along with the rows, the new bottom row has to be cleared
+		memmove(term_dirty_lo, term_dirty_lo + 1, (term_height - 1) * sizeof(*term_dirty_lo));
+		memmove(term_dirty_hi, term_dirty_hi + 1, (term_height - 1) * sizeof(*term_dirty_hi));
+		term_dirty_lo[term_height - 1] = 0;
+		term_dirty_hi[term_height - 1] = 0;
+		term_damage(0, term_height - 1, term_width);
+		term_scrolled++;
 	}
 
 	switch (c) {
@@ -72,12 +309,18 @@ void term_putchar(char c) {
                 case '\t': {
                         term_x += 8;
 
+        		if (term_x >= term_width) {
+        			term_y++;
+        			term_x = 0;
+        		}
+
                         break;
                 }
         
 	        default: {
-        		term_mem[term_y * term_width + term_x] = c;
-        		
+        		term_line(term_y)[term_x] = c;
+        		term_damage(term_x, term_y, 1);
+
         		term_x++;
 
         		if (term_x >= term_width) {
@@ -90,48 +333,353 @@ void term_putchar(char c) {
 	}
 }
 
+/*
+ * Font the atlas is built from, glyphs are font_height rows of
+ * font_pitch bytes each, most significant bit first.
+*/
+static uint8_t *term_font = NULL;
+static int term_font_width = ARC_TERM_ROM_WIDTH;
+static int term_font_height = ARC_TERM_ROM_HEIGHT;
+static int term_font_pitch = 1;
+static int term_font_scale = 1;
+static uint32_t term_fg = 0xFFFFFF;
+static uint32_t term_bg = 0;
+
+/*
+ * All 256 glyphs expanded into framebuffer pixels with the current colors, glyph c
+ * starts at c * term_glyph_size and its rows are term_cell_width pixels apart. The
+ * static atlas is large enough for the character ROM at any bpp, larger fonts need
+ * the allocator.
+*/
+static uint8_t term_atlas_static[256 * ARC_TERM_ROM_WIDTH * ARC_TERM_ROM_HEIGHT * 4] = { 0 };
+static uint8_t *term_atlas = NULL;
+static size_t term_glyph_size = 0;
+
+/*
+ * Glyph expanders specialized per bpp, so that the inner loop is a plain store
+ * instead of a switch per pixel. Glyph 0 is expanded to a blank cell.
+*/
+#define ARC_TERM_GLYPH_EXPANDER(__bpp, __type, __store)					\
+	static void term_expand_glyph_##__bpp(uint8_t *dest, uint8_t *glyph) {		\
+		__type *pixel = (__type *)dest;						\
+		for (int i = 0; i < term_cell_height; i++) {				\
+			uint8_t *row = glyph == NULL ? NULL : glyph + (i / term_font_scale) * term_font_pitch; \
+			for (int j = 0; j < term_cell_width; j++, pixel++) {		\
+				int bit = j / term_font_scale;				\
+				uint32_t color = (row != NULL && ((row[bit / 8] >> (7 - bit % 8)) & 1)) ? term_fg : term_bg; \
+				__store;						\
+			}								\
+		}									\
+	}
+
+ARC_TERM_GLYPH_EXPANDER(32, uint32_t, *pixel = color)
+ARC_TERM_GLYPH_EXPANDER(24, uint24_s, pixel->data = color)
+ARC_TERM_GLYPH_EXPANDER(16, uint16_t, *pixel = (uint16_t)color)
+
+static void (*term_expand_glyph)(uint8_t *dest, uint8_t *glyph) = NULL;
+
+/// RAM copy of the framebuffer that cells are drawn into, NULL until init_terminal_shadow
+static uint8_t *term_shadow = NULL;
+
+static inline size_t term_fb_pitch() {
+	return term_fb_width * (term_fb_bpp / 8);
+}
+
+static void term_build_atlas() {
+	size_t font_size = term_font_height * term_font_pitch;
+
+	for (int c = 0; c < 256; c++) {
+		term_expand_glyph(term_atlas + c * term_glyph_size, c == 0 ? NULL : term_font + c * font_size);
+	}
+}
+
+/**
+ * Lay the terminal out in cells of the current size
+ *
+ * Moves the text into a new ring, allocated with room for term_scrollback
+ * lines of history, or term_mem if there is none. The line the cursor is on
+ * and as much as fits before it are carried over.
+*/
+static void term_relayout() {
+	static uint8_t scratch[sizeof(term_mem)];
+	int width = term_fb_width / term_cell_width;
+	int height = term_fb_height / term_cell_height;
+
+	// Keep at least one cell so term_putchar works without a framebuffer
+	width = width < 1 ? 1 : width;
+	height = height < 1 ? 1 : height;
+
+	if (height > ARC_TERM_MAX_ROWS) {
+		height = ARC_TERM_MAX_ROWS;
+	}
+
+	uint8_t *buffer = term_mem;
+	size_t size = sizeof(term_mem);
+
+	if (term_scrollback > 0) {
+		size = (size_t)width * (height + term_scrollback);
+		buffer = (uint8_t *)alloc(size);
+
+		if (buffer == NULL) {
+			ARC_DEBUG(WARN, "Failed to allocate %d lines of scrollback, dropping history\n", term_scrollback);
+			term_scrollback = 0;
+			buffer = term_mem;
+			size = sizeof(term_mem);
+		}
+	}
+
+	if ((size_t)width * height > size) {
+		height = size / width;
+	}
+
+	uint8_t *old = term_buffer;
+
+	if (old == buffer) {
+		// Only term_mem is laid out in place
+		memcpy(scratch, old, sizeof(scratch));
+		old = scratch;
+	}
+
+	int lines = size / width;
+	int rows = term_y + 1 < height ? term_y + 1 : height;
+	int first = term_y + 1 - rows;
+	int history = first + term_history < lines - height ? first + term_history : lines - height;
+	int columns = term_width < width ? term_width : width;
+
+	memset(buffer, 0, size);
+
+	for (int i = 0; term_lines > 0 && i < history + rows; i++) {
+		int y = first - history + i;
+
+		if (y >= term_height) {
+			break;
+		}
+
+		memcpy(buffer + i * width, old + ((term_top + y + term_lines) % term_lines) * term_width, columns);
+	}
+
+	if (term_buffer != term_mem) {
+		free(term_buffer);
+	}
+
+	term_buffer = buffer;
+	term_lines = lines;
+	term_top = history;
+	term_history = history;
+	term_width = width;
+	term_height = height;
+	term_y -= first;
+
+	if (term_x >= term_width) {
+		term_x = 0;
+		term_y++;
+	}
+
+	memset(term_dirty_lo, 0, sizeof(term_dirty_lo));
+	memset(term_dirty_hi, 0, sizeof(term_dirty_hi));
+	term_scrolled = 0;
+	term_redraw_all = 1;
+}
+
+static void term_fill(uint8_t *target) {
+	size_t pitch = term_fb_pitch();
+
+	// Glyph 0 is blank, so its first row is a run of background pixels
+	for (size_t x = 0; x < pitch;) {
+		size_t size = term_cell_width * (term_fb_bpp / 8);
+		size = size > pitch - x ? pitch - x : size;
+		memcpy(target + x, term_atlas, size);
+		x += size;
+	}
+
+	for (int y = 1; y < term_fb_height; y++) {
+		memcpy(target + y * pitch, target, pitch);
+	}
+}
+
+static inline void term_draw_cell(uint8_t *target, int cx, int cy) {
+	size_t pitch = term_fb_pitch();
+	size_t size = term_cell_width * (term_fb_bpp / 8);
+	uint8_t *glyph = term_atlas + term_line(cy)[cx] * term_glyph_size;
+	uint8_t *dest = target + cy * term_cell_height * pitch + cx * size;
+
+	for (int i = 0; i < term_cell_height; i++, dest += pitch, glyph += size) {
+		memcpy(dest, glyph, size);
+	}
+}
+
+/**
+ * Copy columns [lo, hi) of cell row cy from the shadow buffer to the framebuffer
+*/
+static void term_blit_cells(int lo, int hi, int cy) {
+	size_t pitch = term_fb_pitch();
+	size_t from = lo * term_cell_width * (term_fb_bpp / 8);
+	size_t size = (hi - lo) * term_cell_width * (term_fb_bpp / 8);
+	size_t offset = cy * term_cell_height * pitch + from;
+
+	for (int i = 0; i < term_cell_height; i++, offset += pitch) {
+		memcpy((uint8_t *)term_fb + offset, term_shadow + offset, size);
+	}
+
+	term_fb_written += size * term_cell_height;
+}
+
 void term_draw() {
-	if (term_fb == NULL) {
+	if (term_fb == NULL || term_atlas == NULL) {
 		return;
 	}
 
-	memset(term_fb, 0, term_fb_width * term_fb_height * (term_fb_bpp / 8));
+	// Once there is a shadow buffer, the framebuffer is only ever written to in whole rows
+	uint8_t *target = term_shadow != NULL ? term_shadow : (uint8_t *)term_fb;
+	size_t line_size = term_fb_pitch() * term_cell_height;
+	int blit_all = 0;
 
-	int cwidth = 8;
-	int cheight = 8;
-	uint8_t *base = (uint8_t *)ARC_PHYS_TO_HHDM(Arc_BootMeta->term.char_rom);
+	if (term_redraw_all) {
+		term_fill(target);
 
-	if (base == NULL) {
-		return;
+		if (target == term_fb) {
+			term_fb_written += term_fb_height * term_fb_pitch();
+		}
+
+		for (int cy = 0; cy < term_height; cy++) {
+			term_damage(0, cy, term_width);
+		}
+
+		term_redraw_all = 0;
+		blit_all = 1;
+	} else if (term_scrolled > 0 && term_scrolled < term_height) {
+		// Every row has been damaged if the terminal scrolled by its full height
+		memmove(target, target + term_scrolled * line_size, (term_height - term_scrolled) * line_size);
+		blit_all = 1;
+
+		if (target == term_fb) {
+			term_fb_written += (term_height - term_scrolled) * line_size;
+		}
 	}
 
+	term_scrolled = 0;
+
 	for (int cy = 0; cy < term_height; cy++) {
-		for (int cx = 0; cx < term_width; cx++) {
-                        if (cy * term_width + cx > 0x4000)  {
-                                break;
-                        }
+		for (int cx = term_dirty_lo[cy]; cx < term_dirty_hi[cy]; cx++) {
+			term_draw_cell(target, cx, cy);
+		}
+
+		if (target == term_fb) {
+			term_fb_written += (term_dirty_hi[cy] - term_dirty_lo[cy]) * term_glyph_size;
+		} else if (!blit_all && term_dirty_lo[cy] < term_dirty_hi[cy]) {
+			term_blit_cells(term_dirty_lo[cy], term_dirty_hi[cy], cy);
+		}
+
+		term_dirty_lo[cy] = 0;
+		term_dirty_hi[cy] = 0;
+	}
+
+	if (target != term_fb && blit_all) {
+		size_t size = term_fb_height * term_fb_pitch();
+		memcpy(term_fb, term_shadow, size);
+		term_fb_written += size;
+	}
+}
+
+size_t term_read_scrollback(void *buffer, size_t size, size_t offset) {
+	if (buffer == NULL || term_lines == 0) {
+		return 0;
+	}
+
+	size_t position = 0;
+	size_t copied = 0;
+	int last = term_y < term_height ? term_y : term_height - 1;
 
-			char c = term_mem[cy * term_width + cx];
-			int fx = cx * cwidth;
-			int fy = cy * cheight;
+	for (int y = -term_history; y <= last && copied < size; y++) {
+		uint8_t *line = term_line(y);
+		int length = term_width;
 
-			if (c == 0) {
+		while (length > 0 && line[length - 1] == 0) {
+			length--;
+		}
+
+		// Each line is read back as its text up to the last character and a newline
+		if (position + length + 1 <= offset) {
+			position += length + 1;
+			continue;
+		}
+
+		for (int x = 0; x <= length && copied < size; x++, position++) {
+			if (position < offset) {
 				continue;
 			}
-			uint8_t *char_base = (uint8_t *)(base + (c * cheight));
 
-			for (int i = 0; i < cheight; i++) {
-				int _j = 0;
-				for (int j = cwidth - 1; j >= 0; j--, _j++) {
-					if (((char_base[i] >> j) & 1) == 0) {
-						continue;
-					}
+			char c = x == length ? '\n' : (line[x] == 0 ? ' ' : line[x]);
+			((char *)buffer)[copied++] = c;
+		}
+	}
 
-	       			ARC_FB_DRAW(term_fb, (fx + _j), ((i + fy) * term_fb_width), term_fb_bpp, 0xFFFFFF);
-				}
-			}
+	return copied;
+}
+
+uint64_t term_fb_bytes_written() {
+	return term_fb_written;
+}
+
+int term_set_font(uint8_t *glyphs, int width, int height, int scale) {
+	if (term_expand_glyph == NULL || scale < 1) {
+		return -1;
+	}
+
+	if (glyphs == NULL) {
+		glyphs = (uint8_t *)ARC_PHYS_TO_HHDM(Arc_BootMeta->term.char_rom);
+		width = ARC_TERM_ROM_WIDTH;
+		height = ARC_TERM_ROM_HEIGHT;
+	}
+
+	if (glyphs == NULL || width < 1 || height < 1 || width * scale > term_fb_width || height * scale > term_fb_height) {
+		return -1;
+	}
+
+	size_t glyph_size = width * scale * height * scale * (term_fb_bpp / 8);
+	uint8_t *atlas = term_atlas_static;
+
+	if (glyph_size * 256 > sizeof(term_atlas_static)) {
+		atlas = (uint8_t *)alloc(glyph_size * 256);
+
+		if (atlas == NULL) {
+			ARC_DEBUG(ERR, "Failed to allocate glyph atlas for %dx%d font\n", width * scale, height * scale);
+			return -1;
 		}
 	}
+
+	if (term_atlas != NULL && term_atlas != term_atlas_static && term_atlas != atlas) {
+		free(term_atlas);
+	}
+
+	term_atlas = atlas;
+	term_glyph_size = glyph_size;
+	term_font = glyphs;
+	term_font_width = width;
+	term_font_height = height;
+	term_font_pitch = (width + 7) / 8;
+	term_font_scale = scale;
+	term_cell_width = width * scale;
+	term_cell_height = height * scale;
+
+	term_build_atlas();
+	term_relayout();
+
+	return 0;
+}
+
+int term_set_colors(uint32_t fg, uint32_t bg) {
+	if (term_atlas == NULL) {
+		return -1;
+	}
+
+	term_fg = fg;
+	term_bg = bg;
+
+	term_build_atlas();
+	term_redraw_all = 1;
+
+	return 0;
 }
 
 int init_terminal() {
@@ -139,10 +687,74 @@ int init_terminal() {
 	term_fb_width = Arc_BootMeta->term.width;
 	term_fb_height = Arc_BootMeta->term.height;
 	term_fb_bpp = Arc_BootMeta->term.bpp;
-	term_width = term_fb_width / 8;
-	term_height = term_fb_height / 8;
+
+	switch (term_fb_bpp) {
+		case 32:
+			term_expand_glyph = term_expand_glyph_32;
+			break;
+		case 24:
+			term_expand_glyph = term_expand_glyph_24;
+			break;
+		case 16:
+			term_expand_glyph = term_expand_glyph_16;
+			break;
+		default:
+			ARC_DEBUG(WARN, "Unsupported framebuffer bpp %d, not drawing\n", term_fb_bpp);
+			break;
+	}
+
+	if (term_set_font(NULL, 0, 0, 1) != 0) {
+		// Nothing to draw with, keep a grid so output still reaches the COM port
+		term_relayout();
+	}
+
+#ifdef ARC_COM_PORT
+	// Enable and clear the FIFOs so that THRE can be answered with a full batch
+	term_flush();
+	outb(ARC_COM_PORT + 2, 0xC7);
+	term_com_batch = ARC_TERM_COM_FIFO_SIZE;
+#endif
 
 	ARC_DEBUG(INFO, "Initialized terminal (%dx%d)\n", term_width, term_height);
 
 	return 0;
 }
+
+int init_terminal_scrollback(int history) {
+	if (history <= 0) {
+		return -1;
+	}
+
+	term_scrollback = history;
+	term_relayout();
+
+	if (term_buffer == term_mem) {
+		return -1;
+	}
+
+	ARC_DEBUG(INFO, "Terminal keeps %d lines of scrollback\n", term_scrollback);
+
+	return 0;
+}
+
+int init_terminal_shadow() {
+	if (term_fb == NULL) {
+		return -1;
+	}
+
+	size_t size = term_fb_height * term_fb_pitch();
+	uint8_t *shadow = (uint8_t *)alloc(size);
+
+	if (shadow == NULL) {
+		ARC_DEBUG(WARN, "Failed to allocate %lu byte terminal shadow buffer\n", size);
+		return -1;
+	}
+
+	// Render everything once into the shadow, the framebuffer is then overwritten with it
+	term_shadow = shadow;
+	term_redraw_all = 1;
+
+	ARC_DEBUG(INFO, "Allocated terminal shadow buffer (%lu bytes)\n", size);
+
+	return 0;
+}
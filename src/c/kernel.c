@@ -32,7 +32,10 @@
 #include "drivers/dri_defs.h"
 #include "fs/vfs.h"
 #include "global.h"
+#include "interface/boottime.h"
+#include "interface/klog.h"
 #include "interface/printf.h"
+#include "interface/terminal.h"
 #include "lib/checksums.h"
 #include "drivers/resource.h"
 #include "mm/allocator.h"
@@ -47,38 +50,49 @@ int kernel_main(struct ARC_KernelMeta *kernel_meta, struct ARC_BootMeta *boot_me
 	Arc_KernelMeta = kernel_meta;
 	Arc_BootMeta = boot_meta;
 
-	if (init_printf() != 0) {
+	if (ARC_BOOTTIME_PHASE("printf", init_printf()) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize printf\n");
 		ARC_HANG;
 	}
 
-	if (init_arch_early() != 0) {
+	if (ARC_BOOTTIME_PHASE("arch_early", init_arch_early()) != 0) {
 		ARC_DEBUG(ERR, "Failed to intiailize early arch\n");
 		ARC_HANG;
 	}
 
-	if (init_pager() != 0) {
+	if (ARC_BOOTTIME_PHASE("pager", init_pager()) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize pager\n");
 		ARC_HANG;
 	}
 
-	if (init_terminal() != 0) {
+	if (ARC_BOOTTIME_PHASE("terminal", init_terminal()) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize terminal\n");
 		ARC_HANG;
 	}
 
-	if (init_pmm((struct ARC_MMap *)ARC_PHYS_TO_HHDM(Arc_KernelMeta->arc_mmap.base), Arc_KernelMeta->arc_mmap.len) != 0) {
+	if (ARC_BOOTTIME_PHASE("pmm", init_pmm((struct ARC_MMap *)ARC_PHYS_TO_HHDM(Arc_KernelMeta->arc_mmap.base), Arc_KernelMeta->arc_mmap.len)) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize physical memory manager\n");
 		ARC_HANG;
 	}
 
-	if (init_allocator(256) != 0) {
+	if (ARC_BOOTTIME_PHASE("allocator", init_allocator(256)) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize kernel allocator\n");
 		ARC_HANG;
 	}
 
+	if (ARC_BOOTTIME_PHASE("term_scrollback", init_terminal_scrollback(ARC_TERM_SCROLLBACK)) != 0) {
+		ARC_DEBUG(WARN, "Failed to initialize terminal scrollback\n");
+	}
+
+	if (ARC_BOOTTIME_PHASE("term_shadow", init_terminal_shadow()) != 0) {
+		ARC_DEBUG(WARN, "Failed to initialize terminal shadow buffer\n");
+	}
+
+	boottime_begin("checksums");
 	init_checksums();
-	
+	boottime_end(0);
+
+	boottime_begin("vfs");
 	init_vfs();
 	
 	struct ARC_VFSNodeInfo info = {
@@ -91,23 +105,24 @@ int kernel_main(struct ARC_KernelMeta *kernel_meta, struct ARC_BootMeta *boot_me
 
 	struct ARC_Resource *Arc_InitramfsRes = init_resource(ARC_DRIDEF_INITRAMFS_SUPER, (void *)ARC_PHYS_TO_HHDM(Arc_KernelMeta->initramfs.base));
 	vfs_mount("/initramfs/", Arc_InitramfsRes);
+	boottime_end(0);
 
-	if (init_acpi() != 0) {
+	if (ARC_BOOTTIME_PHASE("acpi", init_acpi()) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize ACPI\n");
 		ARC_HANG;
 	}
 
-	if (init_smp() != 0) {
+	if (ARC_BOOTTIME_PHASE("smp", init_smp()) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize SMP\n");
 		ARC_HANG;
 	}
 
-	if (init_arch() != 0) {
+	if (ARC_BOOTTIME_PHASE("arch", init_arch()) != 0) {
 		ARC_DEBUG(ERR, "Failed t oinitialize architecture\n");
 		ARC_HANG;
 	}
 
-	if (init_pci() != 0) {
+	if (ARC_BOOTTIME_PHASE("pci", init_pci()) != 0) {
 		ARC_DEBUG(ERR, "Failed to initialize PCI\n");
 		ARC_HANG;
 	}
@@ -116,7 +131,7 @@ int kernel_main(struct ARC_KernelMeta *kernel_meta, struct ARC_BootMeta *boot_me
 
 	vfs_list("/", 16);
 
-	if (init_scheduler() != 0) {
+	if (ARC_BOOTTIME_PHASE("scheduler", init_scheduler()) != 0) {
 		ARC_DEBUG(ERR, "No scheduler\n");
 		ARC_HANG;
 	}
@@ -128,9 +143,17 @@ int kernel_main(struct ARC_KernelMeta *kernel_meta, struct ARC_BootMeta *boot_me
 	}
 	sched_queue_proc(userspace);
 
+	klog_drain();
+	boottime_print();
+	term_flush();
+
 	ARC_ENABLE_INTERRUPT;
 
-	ARC_HANG;
+	// Idle, anything printed since the last wakeup is still sitting in the COM ring
+	for (;;) {
+		__asm__ volatile("hlt");
+		term_flush();
+	}
 
 	return 0;
 }
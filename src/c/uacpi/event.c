@@ -46,9 +46,87 @@ struct fixed_event {
     uacpi_u16 status_mask;
 };
 
+/*
+ * Bucket N counts events that took [2^(N-1), 2^N) ticks from the SCI to the
+ * completion of their handler, the last bucket anything longer than that.
+ */
+#define EVENT_LATENCY_BUCKETS 24
+
+struct event_latency {
+    uacpi_u32 count;
+    uacpi_u32 min_ticks;
+    uacpi_u32 max_ticks;
+    uacpi_u32 aml_max_ticks;
+    uacpi_u64 total_ticks;
+    uacpi_u64 aml_total_ticks;
+    uacpi_u32 buckets[EVENT_LATENCY_BUCKETS];
+};
+
+static uacpi_u32 latency_clamp(uacpi_u64 ticks)
+{
+    return ticks > 0xFFFFFFFF ? 0xFFFFFFFF : (uacpi_u32)ticks;
+}
+
+static void event_latency_account(
+    struct event_latency *lat, uacpi_u64 ticks, uacpi_u64 aml_ticks
+)
+{
+    uacpi_size bucket;
+
+    bucket = uacpi_bit_scan_backward(ticks);
+    if (bucket >= EVENT_LATENCY_BUCKETS)
+        bucket = EVENT_LATENCY_BUCKETS - 1;
+    lat->buckets[bucket]++;
+
+    if (lat->count == 0 || ticks < lat->min_ticks)
+        lat->min_ticks = latency_clamp(ticks);
+    if (ticks > lat->max_ticks)
+        lat->max_ticks = latency_clamp(ticks);
+    if (aml_ticks > lat->aml_max_ticks)
+        lat->aml_max_ticks = latency_clamp(aml_ticks);
+
+    lat->total_ticks += ticks;
+    lat->aml_total_ticks += aml_ticks;
+    lat->count++;
+}
+
+static void event_latency_get(
+    const struct event_latency *lat, uacpi_event_latency_stats *out_stats
+)
+{
+    uacpi_u32 seen = 0, target;
+    uacpi_size i;
+
+    uacpi_memzero(out_stats, sizeof(*out_stats));
+    if (lat->count == 0)
+        return;
+
+    out_stats->count = lat->count;
+    out_stats->min_ticks = lat->min_ticks;
+    out_stats->max_ticks = lat->max_ticks;
+    out_stats->avg_ticks = lat->total_ticks / lat->count;
+    out_stats->aml_max_ticks = lat->aml_max_ticks;
+    out_stats->aml_avg_ticks = lat->aml_total_ticks / lat->count;
+
+    // Smallest bucket that covers 99% of the events, rounded up
+    target = lat->count - lat->count / 100;
+
+    for (i = 0; i < EVENT_LATENCY_BUCKETS - 1; ++i) {
+        seen += lat->buckets[i];
+        if (seen >= target)
+            break;
+    }
+
+    out_stats->p99_ticks = i == 0 ? 0 : (1ull << i) - 1;
+    if (i == EVENT_LATENCY_BUCKETS - 1 ||
+        out_stats->p99_ticks > out_stats->max_ticks)
+        out_stats->p99_ticks = out_stats->max_ticks;
+}
+
 struct fixed_event_handler {
     uacpi_interrupt_handler handler;
     uacpi_handle ctx;
+    struct event_latency latency;
 };
 
 static const struct fixed_event fixed_events[UACPI_FIXED_EVENT_MAX + 1] = {
@@ -165,10 +243,13 @@ uacpi_status uacpi_clear_fixed_event(uacpi_fixed_event event)
 }
 
 static uacpi_interrupt_ret dispatch_fixed_event(
-    const struct fixed_event *ev, uacpi_fixed_event event
+    const struct fixed_event *ev, uacpi_fixed_event event,
+    uacpi_u64 sci_ticks
 )
 {
     uacpi_status ret;
+    uacpi_interrupt_ret int_ret;
+    uacpi_u64 ticks;
     struct fixed_event_handler *evh = &fixed_event_handlers[event];
 
     ret = uacpi_write_register_field(ev->status_field, ACPI_PM1_STS_CLEAR);
@@ -176,7 +257,7 @@ static uacpi_interrupt_ret dispatch_fixed_event(
         return UACPI_INTERRUPT_NOT_HANDLED;
 
     if (uacpi_unlikely_error(evh->handler == UACPI_NULL)) {
-        uacpi_warn(
+        uacpi_warn_ratelimited(
             "fixed event %d fired but no handler installed, disabling...\n",
             event
         );
@@ -184,10 +265,17 @@ static uacpi_interrupt_ret dispatch_fixed_event(
         return UACPI_INTERRUPT_NOT_HANDLED;
     }
 
-    return evh->handler(evh->ctx);
+    int_ret = evh->handler(evh->ctx);
+
+    ticks = uacpi_kernel_get_ticks() - sci_ticks;
+    event_latency_account(&evh->latency, ticks, 0);
+    uacpi_trace("fixed event %d handled %"UACPI_PRIu64" ticks after SCI\n",
+                event, UACPI_FMT64(ticks));
+
+    return int_ret;
 }
 
-static uacpi_interrupt_ret handle_fixed_events(void)
+static uacpi_interrupt_ret handle_fixed_events(uacpi_u64 sci_ticks)
 {
     uacpi_interrupt_ret int_ret = UACPI_INTERRUPT_NOT_HANDLED;
     uacpi_status ret;
@@ -210,7 +298,7 @@ static uacpi_interrupt_ret handle_fixed_events(void)
             !(enable_mask & ev->enable_mask))
             continue;
 
-        int_ret |= dispatch_fixed_event(ev, i);
+        int_ret |= dispatch_fixed_event(ev, i, sci_ticks);
     }
 
     return int_ret;
@@ -270,6 +358,44 @@ struct gp_event {
     uacpi_u8 triggering : 1;
     uacpi_u8 wake : 1;
     uacpi_u8 block_interrupts : 1;
+
+    // Consecutive polls that found the event inactive
+    uacpi_u8 quiet_polls;
+
+    /*
+     * The flags below change from both interrupt and work context. They're
+     * kept out of the bitfield so that updating one can't clobber another,
+     * and are only ever accessed atomically.
+     */
+
+    // Interrupts are off after a storm, the status is polled instead
+    uacpi_u32 polling;
+
+    // The AML/implicit notify handler is scheduled but hasn't started yet
+    uacpi_u32 work_pending;
+
+    /*
+     * A gpe_storm_poll() chain is scheduled or running for this event. Only
+     * the chain itself clears this, as the last thing it does with the event.
+     */
+    uacpi_u32 poll_scheduled;
+
+    // Firings within the current storm detection window
+    uacpi_u16 window_fires;
+
+    // Start of the storm detection window in milliseconds
+    uacpi_u32 window_start;
+
+    uacpi_u32 fire_count;
+    uacpi_u32 storm_count;
+
+    // Timestamp of the interrupt (or poll) the pending handling started at
+    uacpi_u64 fire_ticks;
+
+    // Time the last run of the AML handler took
+    uacpi_u64 aml_ticks;
+
+    struct event_latency latency;
 };
 
 struct gpe_register {
@@ -281,6 +407,13 @@ struct gpe_register {
     uacpi_u8 masked_mask;
     uacpi_u8 current_mask;
 
+    /*
+     * What was last written to the enable register. Every write to it goes
+     * through gpe_write_enable(), so this is what the hardware has and the
+     * register never has to be read back.
+     */
+    uacpi_u8 enabled_mask;
+
     uacpi_u16 base_idx;
 };
 
@@ -318,6 +451,17 @@ uacpi_u8 gpe_get_mask(struct gp_event *event)
     return 1 << (event->idx - event->reg->base_idx);
 }
 
+static uacpi_status gpe_write_enable(struct gpe_register *reg, uacpi_u8 mask)
+{
+    uacpi_status ret;
+
+    ret = uacpi_gas_write(&reg->enable, mask);
+    if (uacpi_likely_success(ret))
+        reg->enabled_mask = mask;
+
+    return ret;
+}
+
 enum gpe_state {
     GPE_STATE_ENABLED,
     GPE_STATE_ENABLED_CONDITIONALLY,
@@ -326,15 +470,22 @@ enum gpe_state {
 
 static uacpi_status set_gpe_state(struct gp_event *event, enum gpe_state state)
 {
-    uacpi_status ret;
     struct gpe_register *reg = event->reg;
-    uacpi_u64 enable_mask;
+    uacpi_u8 enable_mask;
     uacpi_u8 event_bit;
 
     event_bit = gpe_get_mask(event);
     if (reg->masked_mask & event_bit)
         return UACPI_STATUS_OK;
 
+    /*
+     * Events that are being polled stay disabled like masked ones. This is
+     * kept per event rather than in a register-wide mask, as the 8 events
+     * of a register start and stop polling from different contexts.
+     */
+    if (uacpi_atomic_load32(&event->polling))
+        return UACPI_STATUS_OK;
+
     if (state == GPE_STATE_ENABLED_CONDITIONALLY) {
         if (!(reg->current_mask & event_bit))
             return UACPI_STATUS_OK;
@@ -342,9 +493,7 @@ static uacpi_status set_gpe_state(struct gp_event *event, enum gpe_state state)
         state = GPE_STATE_ENABLED;
     }
 
-    ret = uacpi_gas_read(&reg->enable, &enable_mask);
-    if (uacpi_unlikely_error(ret))
-        return ret;
+    enable_mask = reg->enabled_mask;
 
     switch (state) {
     case GPE_STATE_ENABLED:
@@ -357,7 +506,7 @@ static uacpi_status set_gpe_state(struct gp_event *event, enum gpe_state state)
         return UACPI_STATUS_INVALID_ARGUMENT;
     }
 
-    return uacpi_gas_write(&reg->enable, enable_mask);
+    return gpe_write_enable(reg, enable_mask);
 }
 
 static uacpi_status clear_gpe(struct gp_event *event)
@@ -367,6 +516,23 @@ static uacpi_status clear_gpe(struct gp_event *event)
     return uacpi_gas_write(&reg->status, gpe_get_mask(event));
 }
 
+/*
+ * Handling of the event is complete, account the time since the interrupt
+ * that started it.
+ */
+static void gpe_latency_complete(struct gp_event *event, uacpi_u64 aml_ticks)
+{
+    uacpi_u64 ticks;
+
+    ticks = uacpi_kernel_get_ticks() - event->fire_ticks;
+    event_latency_account(&event->latency, ticks, aml_ticks);
+
+    uacpi_trace(
+        "GPE(%02X) handled %"UACPI_PRIu64" ticks after SCI (%"UACPI_PRIu64
+        " in AML)\n", event->idx, UACPI_FMT64(ticks), UACPI_FMT64(aml_ticks)
+    );
+}
+
 static uacpi_status restore_gpe(struct gp_event *event)
 {
     uacpi_status ret;
@@ -393,12 +559,19 @@ static void async_restore_gpe(uacpi_handle opaque)
         uacpi_error("unable to restore GPE(%02X): %s\n",
                     event->idx, uacpi_status_to_string(ret));
     }
+
+    gpe_latency_complete(event, event->aml_ticks);
 }
 
 static void async_run_gpe_handler(uacpi_handle opaque)
 {
     uacpi_status ret;
     struct gp_event *event = opaque;
+    uacpi_u64 aml_start;
+
+    // Firings from here on need another run of the handler
+    uacpi_atomic_store32(&event->work_pending, UACPI_FALSE);
+    aml_start = uacpi_kernel_get_ticks();
 
     switch (event->handler_type) {
     case GPE_HANDLER_TYPE_AML_HANDLER: {
@@ -449,6 +622,8 @@ static void async_run_gpe_handler(uacpi_handle opaque)
         break;
     }
 
+    event->aml_ticks = uacpi_kernel_get_ticks() - aml_start;
+
     /*
      * We schedule the work as NOTIFICATION to make sure all other notifications
      * finish before this GPE is re-enabled.
@@ -463,8 +638,128 @@ static void async_run_gpe_handler(uacpi_handle opaque)
     }
 }
 
+#ifndef UACPI_GPE_STORM_THRESHOLD
+    /*
+     * A GPE firing this many times within UACPI_GPE_STORM_WINDOW_MS is
+     * considered to be storming and gets switched over to polling.
+     */
+    #define UACPI_GPE_STORM_THRESHOLD 1000
+#endif
+
+#ifndef UACPI_GPE_STORM_WINDOW_MS
+    #define UACPI_GPE_STORM_WINDOW_MS 1000
+#endif
+
+#ifndef UACPI_GPE_STORM_POLL_INTERVAL_MS
+    /*
+     * Time between polls of a storming GPE. Unless the host provides
+     * uacpi_kernel_schedule_delayed_work (UACPI_KERNEL_DELAYED_WORK), each
+     * poll sleeps this long inside a UACPI_WORK_GPE_EXECUTION work item. On
+     * a single threaded GPE queue, that delays every other GPE handler by
+     * up to this much per poll for as long as a GPE keeps storming.
+     */
+    #define UACPI_GPE_STORM_POLL_INTERVAL_MS 100
+#endif
+
+#ifndef UACPI_GPE_STORM_QUIET_POLLS
+    /*
+     * Number of polls in a row that must find a storming GPE inactive before
+     * its interrupt is enabled again.
+     */
+    #define UACPI_GPE_STORM_QUIET_POLLS 10
+#endif
+
+static void gpe_storm_poll(uacpi_handle opaque);
+
+static uacpi_status gpe_schedule_poll(struct gp_event *event)
+{
+#ifdef UACPI_KERNEL_DELAYED_WORK
+    return uacpi_kernel_schedule_delayed_work(
+        UACPI_WORK_GPE_EXECUTION, gpe_storm_poll, event,
+        UACPI_GPE_STORM_POLL_INTERVAL_MS
+    );
+#else
+    return uacpi_kernel_schedule_work(
+        UACPI_WORK_GPE_EXECUTION, gpe_storm_poll, event
+    );
+#endif
+}
+
+/*
+ * Set one of the atomic event flags, returns UACPI_FALSE if it was already
+ * set by someone else.
+ */
+static uacpi_bool gpe_claim_flag(uacpi_u32 *flag)
+{
+    uacpi_u32 expected = UACPI_FALSE;
+
+    return uacpi_atomic_cmpxchg32(flag, &expected, UACPI_TRUE);
+}
+
+/*
+ * Count a firing of the event, returns UACPI_TRUE if it has just crossed the
+ * storm threshold.
+ */
+static uacpi_bool gpe_account_fire(struct gp_event *event)
+{
+    uacpi_u32 now;
+
+    event->fire_count++;
+    if (uacpi_atomic_load32(&event->polling))
+        return UACPI_FALSE;
+
+    now = uacpi_kernel_get_ticks() / (1000 * 10);
+
+    if (now - event->window_start >= UACPI_GPE_STORM_WINDOW_MS) {
+        event->window_start = now;
+        event->window_fires = 0;
+    }
+
+    return ++event->window_fires >= UACPI_GPE_STORM_THRESHOLD;
+}
+
+static void gpe_start_polling(struct gp_event *event)
+{
+    uacpi_status ret;
+
+    /*
+     * The chain from an earlier storm hasn't noticed it was stopped yet. Keep
+     * handling interrupts until it's gone, the next firing tries again.
+     */
+    if (!gpe_claim_flag(&event->poll_scheduled))
+        return;
+
+    uacpi_atomic_store32(&event->polling, UACPI_TRUE);
+    event->quiet_polls = 0;
+    event->window_fires = 0;
+    event->storm_count++;
+
+    uacpi_warn_ratelimited(
+        "GPE(%02X) fired %d times within %dms, polling it instead\n",
+        event->idx, UACPI_GPE_STORM_THRESHOLD, UACPI_GPE_STORM_WINDOW_MS
+    );
+
+    ret = gpe_schedule_poll(event);
+    if (uacpi_unlikely_error(ret)) {
+        uacpi_error("unable to schedule GPE(%02X) polling: %s\n",
+                    event->idx, uacpi_status_to_string(ret));
+        uacpi_atomic_store32(&event->polling, UACPI_FALSE);
+        uacpi_atomic_store32(&event->poll_scheduled, UACPI_FALSE);
+    }
+}
+
+/*
+ * Stop polling the event. Its interrupt is left disabled, the caller decides
+ * whether it should be enabled again.
+ */
+static void gpe_stop_polling(struct gp_event *event)
+{
+    uacpi_atomic_store32(&event->polling, UACPI_FALSE);
+}
+
 static uacpi_interrupt_ret dispatch_gpe(
-    uacpi_namespace_node *device_node, struct gp_event *event
+    uacpi_namespace_node *device_node, struct gp_event *event,
+    uacpi_u64 sci_ticks
 )
 {
     uacpi_status ret;
@@ -490,6 +785,17 @@ static uacpi_interrupt_ret dispatch_gpe(
 
     event->block_interrupts = UACPI_TRUE;
 
+    // A coalesced firing is accounted to the one still waiting for handling
+    if (!uacpi_atomic_load32(&event->work_pending))
+        event->fire_ticks = sci_ticks;
+
+    /*
+     * The event is handled as usual even if it turns out to be storming,
+     * polling only kicks in for whatever comes after it.
+     */
+    if (uacpi_unlikely(gpe_account_fire(event)))
+        gpe_start_polling(event);
+
     if (event->triggering == UACPI_GPE_TRIGGERING_EDGE) {
         ret = clear_gpe(event);
         if (uacpi_unlikely_error(ret)) {
@@ -505,23 +811,32 @@ static uacpi_interrupt_ret dispatch_gpe(
         int_ret = event->native_handler->cb(
             event->native_handler->ctx, device_node, event->idx
         );
-        if (!(int_ret & UACPI_GPE_REENABLE))
-            break;
-
-        ret = restore_gpe(event);
-        if (uacpi_unlikely_error(ret)) {
-            uacpi_error("unable to restore GPE(%02X): %s\n",
-                        event->idx, uacpi_status_to_string(ret));
+        if (int_ret & UACPI_GPE_REENABLE) {
+            ret = restore_gpe(event);
+            if (uacpi_unlikely_error(ret)) {
+                uacpi_error("unable to restore GPE(%02X): %s\n",
+                            event->idx, uacpi_status_to_string(ret));
+            }
         }
+
+        gpe_latency_complete(event, 0);
         break;
 
     case GPE_HANDLER_TYPE_AML_HANDLER:
     case GPE_HANDLER_TYPE_IMPLICIT_NOTIFY:
+        /*
+         * A polled event may fire again before its handler got to run, that
+         * one run covers both firings.
+         */
+        if (!gpe_claim_flag(&event->work_pending))
+            break;
+
         ret = uacpi_kernel_schedule_work(
             UACPI_WORK_GPE_EXECUTION, async_run_gpe_handler, event
         );
         if (uacpi_unlikely_error(ret)) {
-            uacpi_warn(
+            uacpi_atomic_store32(&event->work_pending, UACPI_FALSE);
+            uacpi_warn_ratelimited(
                 "unable to schedule GPE(%02X) for execution: %s\n",
                 event->idx, uacpi_status_to_string(ret)
             );
@@ -529,47 +844,55 @@ static uacpi_interrupt_ret dispatch_gpe(
         break;
 
     default:
-        uacpi_warn("GPE(%02X) fired but no handler, keeping disabled\n",
-                   event->idx);
+        uacpi_warn_ratelimited(
+            "GPE(%02X) fired but no handler, keeping disabled\n", event->idx
+        );
         break;
     }
 
     return UACPI_INTERRUPT_HANDLED;
 }
 
-static uacpi_interrupt_ret detect_gpes(struct gpe_block *block)
+static uacpi_interrupt_ret detect_gpes(
+    struct gpe_block *block, uacpi_u64 irq_ticks
+)
 {
     uacpi_status ret;
     uacpi_interrupt_ret int_ret = UACPI_INTERRUPT_NOT_HANDLED;
     struct gpe_register *reg;
     struct gp_event *event;
-    uacpi_u64 status, enable;
+    uacpi_u64 status;
+    uacpi_u8 enable;
     uacpi_size i, j;
 
     while (block) {
         for (i = 0; i < block->num_registers; ++i) {
             reg = &block->registers[i];
 
-            if (!reg->runtime_mask && !reg->wake_mask)
+            /*
+             * Nothing enabled in this register can't have raised the
+             * interrupt, don't bother reading its status.
+             */
+            enable = reg->enabled_mask;
+            if (!enable)
                 continue;
 
             ret = uacpi_gas_read(&reg->status, &status);
             if (uacpi_unlikely_error(ret))
                 return int_ret;
 
-            ret = uacpi_gas_read(&reg->enable, &enable);
-            if (uacpi_unlikely_error(ret))
-                return int_ret;
-
+            status &= enable;
             if (status == 0)
                 continue;
 
             for (j = 0; j < EVENTS_PER_GPE_REGISTER; ++j) {
-                if (!((status & enable) & (1ull << j)))
+                if (!(status & (1ull << j)))
                     continue;
 
                 event = &block->events[j + i * EVENTS_PER_GPE_REGISTER];
-                int_ret |= dispatch_gpe(block->device_node, event);
+                int_ret |= dispatch_gpe(
+                    block->device_node, event, irq_ticks
+                );
             }
         }
 
@@ -594,18 +917,23 @@ static uacpi_status maybe_dispatch_gpe(
     if (!(status & gpe_get_mask(event)))
         return ret;
 
-    dispatch_gpe(gpe_device, event);
+    dispatch_gpe(gpe_device, event, uacpi_kernel_get_ticks());
     return ret;
 }
 
-static uacpi_interrupt_ret handle_gpes(uacpi_handle opaque)
+static uacpi_interrupt_ret handle_gpes_since(
+    struct gpe_interrupt_ctx *ctx, uacpi_u64 irq_ticks
+)
 {
-    struct gpe_interrupt_ctx *ctx = opaque;
-
     if (uacpi_unlikely(ctx == UACPI_NULL))
         return UACPI_INTERRUPT_NOT_HANDLED;
 
-    return detect_gpes(ctx->gpe_head);
+    return detect_gpes(ctx->gpe_head, irq_ticks);
+}
+
+static uacpi_interrupt_ret handle_gpes(uacpi_handle opaque)
+{
+    return handle_gpes_since(opaque, uacpi_kernel_get_ticks());
 }
 
 static uacpi_status find_or_create_gpe_interrupt_ctx(
@@ -712,13 +1040,40 @@ static void uninstall_gpe_block(struct gpe_block *block)
             reg = &block->registers[i];
 
             if (reg->current_mask)
-                uacpi_gas_write(&reg->enable, 0x00);
+                gpe_write_enable(reg, 0x00);
         }
     }
 
     if (block->events != UACPI_NULL) {
         uacpi_size i;
         struct gp_event *event;
+        uacpi_bool poll_scheduled;
+
+        /*
+         * Make sure no poll is still looking at the events we're about to
+         * free. A chain may have been stopped earlier without anyone waiting
+         * for it, so look at what's scheduled rather than what's polling, and
+         * keep waiting in case a poll that was already running re-armed
+         * itself before it saw it was stopped.
+         */
+        for (i = 0; i < block->num_events; ++i)
+            gpe_stop_polling(&block->events[i]);
+
+        for (;;) {
+            poll_scheduled = UACPI_FALSE;
+
+            for (i = 0; i < block->num_events; ++i) {
+                event = &block->events[i];
+
+                if (uacpi_atomic_load32(&event->poll_scheduled))
+                    poll_scheduled = UACPI_TRUE;
+            }
+
+            if (!poll_scheduled)
+                break;
+
+            uacpi_kernel_wait_for_work_completion();
+        }
 
         for (i = 0; i < block->num_events; ++i) {
             event = &block->events[i];
@@ -946,7 +1301,7 @@ static uacpi_status create_gpe_block(
          * Disable all GPEs in this register & clear anything that might be
          * pending from earlier.
          */
-        ret = uacpi_gas_write(&reg->enable, 0x00);
+        ret = gpe_write_enable(reg, 0x00);
         if (uacpi_unlikely_error(ret))
             goto error_out;
 
@@ -1045,6 +1400,81 @@ static struct gp_event *get_gpe(
     return ctx.out_event;
 }
 
+static enum gpe_block_iteration_decision do_find_gpe_block_of_event(
+    struct gpe_block *block, uacpi_handle opaque
+)
+{
+    struct gpe_search_ctx *ctx = opaque;
+
+    if (ctx->out_event < block->events ||
+        ctx->out_event >= &block->events[block->num_events])
+        return GPE_BLOCK_ITERATION_DECISION_CONTINUE;
+
+    ctx->out_block = block;
+    return GPE_BLOCK_ITERATION_DECISION_BREAK;
+}
+
+static void gpe_storm_poll(uacpi_handle opaque)
+{
+    uacpi_status ret;
+    struct gp_event *event = opaque;
+    struct gpe_search_ctx ctx = {
+        .out_event = event,
+    };
+    uacpi_u64 status;
+
+#ifndef UACPI_KERNEL_DELAYED_WORK
+    uacpi_kernel_sleep(UACPI_GPE_STORM_POLL_INTERVAL_MS);
+#endif
+
+    /*
+     * Stopped while we were asleep. Whoever stopped us waits for
+     * poll_scheduled to clear before freeing the event, so it's still here.
+     */
+    if (!uacpi_atomic_load32(&event->polling))
+        goto out_done;
+
+    for_each_gpe_block(do_find_gpe_block_of_event, &ctx);
+    if (uacpi_unlikely(ctx.out_block == UACPI_NULL))
+        goto out_done;
+
+    ret = uacpi_gas_read(&event->reg->status, &status);
+    if (uacpi_unlikely_error(ret))
+        goto out_rearm;
+
+    if (status & gpe_get_mask(event)) {
+        event->quiet_polls = 0;
+        dispatch_gpe(
+            ctx.out_block->device_node, event, uacpi_kernel_get_ticks()
+        );
+    } else if (++event->quiet_polls >= UACPI_GPE_STORM_QUIET_POLLS) {
+        uacpi_info_ratelimited(
+            "GPE(%02X) has calmed down, enabling it again\n", event->idx
+        );
+        goto out_rearm;
+    }
+
+    ret = gpe_schedule_poll(event);
+    if (uacpi_likely_success(ret))
+        return;
+
+    uacpi_error("unable to schedule GPE(%02X) polling: %s\n",
+                event->idx, uacpi_status_to_string(ret));
+
+out_rearm:
+    gpe_stop_polling(event);
+
+    ret = restore_gpe(event);
+    if (uacpi_unlikely_error(ret)) {
+        uacpi_error("unable to restore GPE(%02X): %s\n",
+                    event->idx, uacpi_status_to_string(ret));
+    }
+
+out_done:
+    // The event must not be touched past this point
+    uacpi_atomic_store32(&event->poll_scheduled, UACPI_FALSE);
+}
+
 static uacpi_status gpe_remove_user(struct gp_event *event)
 {
     uacpi_status ret = UACPI_STATUS_OK;
@@ -1053,6 +1483,8 @@ static uacpi_status gpe_remove_user(struct gp_event *event)
         return UACPI_STATUS_INVALID_ARGUMENT;
 
     if (--event->num_users == 0) {
+        gpe_stop_polling(event);
+
         event->reg->runtime_mask &= ~gpe_get_mask(event);
         event->reg->current_mask = event->reg->runtime_mask;
 
@@ -1244,7 +1676,7 @@ uacpi_status uacpi_finalize_gpe_initialization(void)
 
     for_each_gpe_block(do_initialize_gpe_block, &poll_blocks);
     if (poll_blocks)
-        detect_gpes(gpe_interrupt_head->gpe_head);
+        detect_gpes(gpe_interrupt_head->gpe_head, uacpi_kernel_get_ticks());
 
     gpes_finalized = UACPI_TRUE;
     return UACPI_STATUS_OK;
@@ -1289,6 +1721,9 @@ uacpi_status uacpi_uninstall_gpe_handler(
     if (uacpi_unlikely(native_handler->cb != handler))
         return UACPI_STATUS_INVALID_ARGUMENT;
 
+    // The previous handler starts out with interrupts like it used to
+    gpe_stop_polling(event);
+
     event->aml_handler = native_handler->previous_handler;
     event->triggering = native_handler->previous_triggering;
     event->handler_type = native_handler->previous_handler_type;
@@ -1629,7 +2064,7 @@ static enum gpe_block_iteration_decision do_for_all_gpes(
         }
 
         reg->current_mask = value;
-        ctx->ret = uacpi_gas_write(&reg->enable, value);
+        ctx->ret = gpe_write_enable(reg, value);
         if (uacpi_unlikely_error(ctx->ret))
             return GPE_BLOCK_ITERATION_DECISION_BREAK;
     }
@@ -1786,16 +2221,47 @@ out:
     return UACPI_INTERRUPT_HANDLED;
 }
 
+/*
+ * The SCI handler is never entered on two CPUs at once, so it's the only
+ * writer and doesn't need any atomics to update this.
+ */
+static uacpi_sci_latency_stats sci_latency_stats;
+
+static void sci_latency_account(uacpi_u64 ticks)
+{
+    uacpi_size bucket;
+
+    bucket = uacpi_bit_scan_backward(ticks);
+    if (bucket >= UACPI_SCI_LATENCY_BUCKETS)
+        bucket = UACPI_SCI_LATENCY_BUCKETS - 1;
+
+    sci_latency_stats.buckets[bucket]++;
+    if (ticks > sci_latency_stats.max_ticks)
+        sci_latency_stats.max_ticks = ticks;
+}
+
 static uacpi_interrupt_ret handle_sci(uacpi_handle ctx)
 {
     uacpi_interrupt_ret int_ret = UACPI_INTERRUPT_NOT_HANDLED;
+    uacpi_u64 start;
+
+    start = uacpi_kernel_get_ticks();
 
-    int_ret |= handle_fixed_events();
-    int_ret |= handle_gpes(ctx);
+    int_ret |= handle_fixed_events(start);
+    int_ret |= handle_gpes_since(ctx, start);
 
+    sci_latency_account(uacpi_kernel_get_ticks() - start);
     return int_ret;
 }
 
+uacpi_status uacpi_get_sci_latency_stats(uacpi_sci_latency_stats *out_stats)
+{
+    UACPI_ENSURE_INIT_LEVEL_AT_LEAST(UACPI_INIT_LEVEL_NAMESPACE_LOADED);
+
+    uacpi_memcpy(out_stats, &sci_latency_stats, sizeof(*out_stats));
+    return UACPI_STATUS_OK;
+}
+
 uacpi_status uacpi_initialize_events(void)
 {
     uacpi_status ret;
@@ -1872,6 +2338,10 @@ void uacpi_deinitialize_events(void)
             uacpi_uninstall_fixed_event_handler(i);
     }
 
+    // Don't carry latency statistics over to the next initialization
+    uacpi_memzero(fixed_event_handlers, sizeof(fixed_event_handlers));
+    uacpi_memzero(&sci_latency_stats, sizeof(sci_latency_stats));
+
     gpe_interrupt_head = UACPI_NULL;
 }
 
@@ -1965,6 +2435,19 @@ uacpi_status uacpi_fixed_event_info(
     return UACPI_STATUS_OK;
 }
 
+uacpi_status uacpi_fixed_event_stats(
+    uacpi_fixed_event event, uacpi_event_latency_stats *out_stats
+)
+{
+    if (uacpi_unlikely(event > UACPI_FIXED_EVENT_MAX))
+        return UACPI_STATUS_INVALID_ARGUMENT;
+    if (uacpi_is_hardware_reduced())
+        return UACPI_STATUS_NOT_FOUND;
+
+    event_latency_get(&fixed_event_handlers[event].latency, out_stats);
+    return UACPI_STATUS_OK;
+}
+
 uacpi_status uacpi_gpe_info(
     uacpi_namespace_node *gpe_device, uacpi_u16 idx, uacpi_event_info *out_info
 )
@@ -1992,6 +2475,8 @@ uacpi_status uacpi_gpe_info(
         info |= UACPI_EVENT_INFO_MASKED;
     if (reg->wake_mask & mask)
         info |= UACPI_EVENT_INFO_ENABLED_FOR_WAKE;
+    if (uacpi_atomic_load32(&event->polling))
+        info |= UACPI_EVENT_INFO_POLLING;
 
     ret = uacpi_gas_read(&reg->enable, &raw_value);
     if (uacpi_unlikely_error(ret))
@@ -2009,6 +2494,24 @@ uacpi_status uacpi_gpe_info(
     return UACPI_STATUS_OK;
 }
 
+uacpi_status uacpi_gpe_stats(
+    uacpi_namespace_node *gpe_device, uacpi_u16 idx,
+    uacpi_gpe_event_stats *out_stats
+)
+{
+    uacpi_status ret;
+    struct gp_event *event;
+
+    ret = sanitize_device_and_find_gpe(&gpe_device, idx, &event);
+    if (uacpi_unlikely_error(ret))
+        return ret;
+
+    out_stats->fire_count = event->fire_count;
+    out_stats->storm_count = event->storm_count;
+    event_latency_get(&event->latency, &out_stats->latency);
+    return UACPI_STATUS_OK;
+}
+
 #define PM1_STATUS_BITS (               \
     ACPI_PM1_STS_TMR_STS_MASK |         \
     ACPI_PM1_STS_BM_STS_MASK |          \
@@ -43,6 +43,113 @@
 #include <uacpi/internal/mutex.h>
 #include <uacpi/internal/osi.h>
 
+/*
+ * AML execution is serialized by a single interpreter-wide lock: neither the
+ * interpreter state shared between methods (named objects, region and field
+ * state, the namespace itself) nor the AML that manipulates it are written
+ * with concurrent execution in mind. Same as in ACPICA, the lock is dropped
+ * around anything that may block for a long time (Sleep, Wait, blocking on a
+ * mutex) so that methods running on other threads can make progress.
+ *
+ * The lock is recursive so that host callbacks invoked by the interpreter
+ * (e.g. address space handlers) are still able to evaluate AML.
+ */
+static uacpi_handle interpreter_mutex;
+static uacpi_thread_id interpreter_owner = UACPI_THREAD_ID_NONE;
+static uacpi_u32 interpreter_depth;
+
+uacpi_status uacpi_initialize_interpreter(void)
+{
+    interpreter_mutex = uacpi_kernel_create_mutex();
+    if (uacpi_unlikely(interpreter_mutex == UACPI_NULL))
+        return UACPI_STATUS_OUT_OF_MEMORY;
+
+    return UACPI_STATUS_OK;
+}
+
+void uacpi_deinitialize_interpreter(void)
+{
+    if (interpreter_mutex != UACPI_NULL)
+        uacpi_kernel_free_mutex(interpreter_mutex);
+
+    interpreter_mutex = UACPI_NULL;
+    UACPI_ATOMIC_STORE_THREAD_ID(&interpreter_owner, UACPI_THREAD_ID_NONE);
+    interpreter_depth = 0;
+}
+
+static uacpi_bool this_thread_owns_interpreter(void)
+{
+    return UACPI_ATOMIC_LOAD_THREAD_ID(&interpreter_owner) ==
+           uacpi_kernel_get_thread_id();
+}
+
+static uacpi_status interpreter_lock(uacpi_u32 depth)
+{
+    if (interpreter_mutex == UACPI_NULL)
+        return UACPI_STATUS_OK;
+
+    UACPI_MUTEX_ACQUIRE(interpreter_mutex);
+    UACPI_ATOMIC_STORE_THREAD_ID(
+        &interpreter_owner, uacpi_kernel_get_thread_id()
+    );
+    interpreter_depth = depth;
+    return UACPI_STATUS_OK;
+}
+
+static void interpreter_unlock(void)
+{
+    if (interpreter_mutex == UACPI_NULL)
+        return;
+
+    interpreter_depth = 0;
+    UACPI_ATOMIC_STORE_THREAD_ID(&interpreter_owner, UACPI_THREAD_ID_NONE);
+    UACPI_MUTEX_RELEASE(interpreter_mutex);
+}
+
+uacpi_status uacpi_interpreter_enter(void)
+{
+    if (this_thread_owns_interpreter()) {
+        interpreter_depth++;
+        return UACPI_STATUS_OK;
+    }
+
+    return interpreter_lock(1);
+}
+
+void uacpi_interpreter_exit(void)
+{
+    if (interpreter_depth-- > 1)
+        return;
+
+    interpreter_unlock();
+}
+
+uacpi_u32 uacpi_interpreter_suspend(void)
+{
+    uacpi_u32 depth;
+
+    if (!this_thread_owns_interpreter())
+        return 0;
+
+    depth = interpreter_depth;
+    interpreter_unlock();
+    return depth;
+}
+
+void uacpi_interpreter_resume(uacpi_u32 depth)
+{
+    if (depth == 0)
+        return;
+
+    /*
+     * There's no way to report a failure to the caller here, and
+     * UACPI_MUTEX_ACQUIRE is only allowed to fail with an infinite timeout
+     * if the host is badly broken.
+     */
+    if (uacpi_unlikely_error(interpreter_lock(depth)))
+        uacpi_error("unable to re-enter the interpreter\n");
+}
+
 enum item_type {
     ITEM_NONE = 0,
     ITEM_NAMESPACE_NODE,
@@ -341,12 +448,180 @@ static struct call_frame *call_frame_array_one_before_last(
     return call_frame_array_at(arr, size - 2);
 }
 
+/*
+ * Bump allocator backing the spill buffers of every dynamic array owned by a
+ * single execution context (call frames, op contexts, items, code blocks,
+ * held mutexes and temporary node lists). All of that state dies together in
+ * execution_context_release(), where the chunks are released in one go.
+ *
+ * Arrays grow by doubling and free their old buffer every time, so freed
+ * blocks are kept on per size class free lists and handed out again to the
+ * next request of the same class. Blocks are rounded up to a power of two for
+ * that, and freeing the most recent allocation simply rolls the chunk back.
+ *
+ * Nothing that can outlive the evaluation (objects, namespace nodes, strings
+ * and buffers) is ever allocated from here.
+ */
+#define EVAL_ARENA_CHUNK_SIZE 4096
+#define EVAL_ARENA_MAX_SIZE (64 * 1024)
+#define EVAL_ARENA_ALIGNMENT 16
+
+// EVAL_ARENA_ALIGNMENT << (EVAL_ARENA_SIZE_CLASSES - 1) == EVAL_ARENA_MAX_SIZE
+#define EVAL_ARENA_SIZE_CLASSES 13
+
+struct eval_arena_chunk {
+    struct eval_arena_chunk *prev;
+    uacpi_size capacity;
+    uacpi_size used;
+};
+
+#define EVAL_ARENA_CHUNK_HDR_SIZE                                            \
+    UACPI_ALIGN_UP(                                                          \
+        sizeof(struct eval_arena_chunk), EVAL_ARENA_ALIGNMENT, uacpi_size    \
+    )
+
+struct eval_arena_free_block {
+    struct eval_arena_free_block *next;
+};
+
+struct eval_arena {
+    struct eval_arena_chunk *head;
+    void *last_alloc;
+    uacpi_size total_capacity;
+    struct eval_arena_free_block *free_lists[EVAL_ARENA_SIZE_CLASSES];
+};
+
+static uacpi_u8 *eval_arena_chunk_data(struct eval_arena_chunk *chunk)
+{
+    return (uacpi_u8*)chunk + EVAL_ARENA_CHUNK_HDR_SIZE;
+}
+
+// 'size' must be aligned and no larger than EVAL_ARENA_MAX_SIZE
+static uacpi_u8 eval_arena_size_class(uacpi_size size)
+{
+    uacpi_u8 size_class = 0;
+
+    while (((uacpi_size)EVAL_ARENA_ALIGNMENT << size_class) < size)
+        size_class++;
+
+    return size_class;
+}
+
+static void *eval_arena_alloc(void *ctx, uacpi_size size)
+{
+    struct eval_arena *arena = ctx;
+    struct eval_arena_chunk *chunk = arena->head;
+    struct eval_arena_free_block *block;
+    uacpi_size block_size;
+    uacpi_u8 size_class;
+    uacpi_u8 *ret;
+
+    size = UACPI_ALIGN_UP(size, EVAL_ARENA_ALIGNMENT, uacpi_size);
+    if (size > EVAL_ARENA_MAX_SIZE)
+        return uacpi_kernel_alloc(size);
+
+    size_class = eval_arena_size_class(size);
+    block = arena->free_lists[size_class];
+    if (block != UACPI_NULL) {
+        arena->free_lists[size_class] = block->next;
+        return block;
+    }
+
+    block_size = (uacpi_size)EVAL_ARENA_ALIGNMENT << size_class;
+
+    if (chunk == UACPI_NULL || (chunk->capacity - chunk->used) < block_size) {
+        uacpi_size capacity = UACPI_MAX(block_size, EVAL_ARENA_CHUNK_SIZE);
+
+        /*
+         * Something is recursing or looping very deeply, don't let the arena
+         * grow unbounded as its chunks are only released once it's reset.
+         */
+        if (arena->total_capacity + capacity > EVAL_ARENA_MAX_SIZE)
+            return uacpi_kernel_alloc(size);
+
+        chunk = uacpi_kernel_alloc(EVAL_ARENA_CHUNK_HDR_SIZE + capacity);
+        if (uacpi_unlikely(chunk == UACPI_NULL))
+            return chunk;
+
+        chunk->prev = arena->head;
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        arena->head = chunk;
+        arena->total_capacity += capacity;
+    }
+
+    ret = eval_arena_chunk_data(chunk) + chunk->used;
+    chunk->used += block_size;
+    arena->last_alloc = ret;
+    return ret;
+}
+
+static uacpi_bool eval_arena_owns(struct eval_arena *arena, void *mem)
+{
+    struct eval_arena_chunk *chunk;
+    uacpi_u8 *data;
+
+    for (chunk = arena->head; chunk != UACPI_NULL; chunk = chunk->prev) {
+        data = eval_arena_chunk_data(chunk);
+
+        if ((uacpi_u8*)mem >= data && (uacpi_u8*)mem < data + chunk->capacity)
+            return UACPI_TRUE;
+    }
+
+    return UACPI_FALSE;
+}
+
+static void eval_arena_free(void *ctx, void *mem, uacpi_size size)
+{
+    struct eval_arena *arena = ctx;
+    struct eval_arena_chunk *chunk = arena->head;
+    struct eval_arena_free_block *block;
+    uacpi_u8 size_class;
+
+    if (!eval_arena_owns(arena, mem)) {
+        uacpi_free(mem, UACPI_ALIGN_UP(size, EVAL_ARENA_ALIGNMENT, uacpi_size));
+        return;
+    }
+
+    // The most recent allocation always lives in the head chunk
+    if (mem == arena->last_alloc) {
+        chunk->used = (uacpi_u8*)mem - eval_arena_chunk_data(chunk);
+        arena->last_alloc = UACPI_NULL;
+        return;
+    }
+
+    size_class = eval_arena_size_class(
+        UACPI_ALIGN_UP(size, EVAL_ARENA_ALIGNMENT, uacpi_size)
+    );
+    block = mem;
+    block->next = arena->free_lists[size_class];
+    arena->free_lists[size_class] = block;
+}
+
+static void eval_arena_release(struct eval_arena *arena)
+{
+    struct eval_arena_chunk *chunk, *prev;
+
+    for (chunk = arena->head; chunk != UACPI_NULL; chunk = prev) {
+        prev = chunk->prev;
+        uacpi_free(chunk, EVAL_ARENA_CHUNK_HDR_SIZE + chunk->capacity);
+    }
+
+    arena->head = UACPI_NULL;
+    arena->last_alloc = UACPI_NULL;
+    arena->total_capacity = 0;
+    uacpi_memzero(arena->free_lists, sizeof(arena->free_lists));
+}
+
 // NOTE: Try to keep size under 2 pages
 struct execution_context {
     uacpi_object *ret;
     struct call_frame_array call_stack;
     struct held_mutexes_array held_mutexes;
 
+    struct eval_arena arena;
+    struct uacpi_dynamic_array_allocator allocator;
+
     struct call_frame *cur_frame;
     struct code_block *cur_block;
     const struct uacpi_op_spec *cur_op;
@@ -492,26 +767,183 @@ static uacpi_status name_string_to_path(
     return UACPI_STATUS_OK;
 }
 
-enum resolve_behavior {
-    RESOLVE_CREATE_LAST_NAMESEG_FAIL_IF_EXISTS,
-    RESOLVE_FAIL_IF_DOESNT_EXIST,
+/*
+ * A NameString that has already been validated and split into its prefix and
+ * NamePath parts. The segments themselves are not copied, they're read back
+ * from the method body at 'offset + segs_offset' on every resolution.
+ */
+struct decoded_name_string {
+    // Offset of the first byte of the NameString within the method + 1
+    uacpi_u32 key;
+    uacpi_u32 length;
+    uacpi_u32 segs_offset;
+    uacpi_u32 parent_prefixes;
+    uacpi_u8 num_segs;
+
+#define DECODED_NAME_STRING_ROOT (1 << 0)
+#define DECODED_NAME_STRING_NULL_NAME (1 << 1)
+#define DECODED_NAME_STRING_JUST_ONE_NAMESEG (1 << 2)
+    uacpi_u8 flags;
 };
 
-static uacpi_status resolve_name_string(
-    struct call_frame *frame,
-    enum resolve_behavior behavior,
-    struct uacpi_namespace_node **out_node
+/*
+ * Per-method cache of decoded NameStrings keyed by their code offset.
+ * Built lazily the first time a method resolves a name and lives for as long
+ * as the method object itself, which never outlives the table its code points
+ * into.
+ */
+struct uacpi_method_decode_cache {
+    uacpi_u32 capacity_mask;
+    uacpi_u32 count;
+    struct decoded_name_string *entries;
+};
+
+#define DECODE_CACHE_INITIAL_CAPACITY 16
+
+static uacpi_u32 decode_cache_slot(
+    const struct uacpi_method_decode_cache *cache, uacpi_u32 key
 )
 {
-    uacpi_status ret = UACPI_STATUS_OK;
-    uacpi_u8 *cursor;
-    uacpi_size bytes_left, namesegs = 0;
-    struct uacpi_namespace_node *parent, *cur_node = frame->cur_scope;
+    return (key * 0x9E3779B1u) & cache->capacity_mask;
+}
+
+void uacpi_method_decode_cache_free(uacpi_control_method *method)
+{
+    struct uacpi_method_decode_cache *cache = method->decode_cache;
+
+    if (cache == UACPI_NULL)
+        return;
+
+    uacpi_free(
+        cache->entries, sizeof(*cache->entries) * (cache->capacity_mask + 1)
+    );
+    uacpi_free(cache, sizeof(*cache));
+    method->decode_cache = UACPI_NULL;
+}
+
+static struct decoded_name_string *decode_cache_lookup(
+    uacpi_control_method *method, uacpi_u32 offset
+)
+{
+    struct uacpi_method_decode_cache *cache = method->decode_cache;
+    struct decoded_name_string *entry;
+    uacpi_u32 slot, key = offset + 1;
+
+    if (cache == UACPI_NULL)
+        return UACPI_NULL;
+
+    slot = decode_cache_slot(cache, key);
+
+    for (;;) {
+        entry = &cache->entries[slot];
+
+        if (entry->key == key)
+            return entry;
+        if (entry->key == 0)
+            return UACPI_NULL;
+
+        slot = (slot + 1) & cache->capacity_mask;
+    }
+}
+
+static void decode_cache_do_insert(
+    struct uacpi_method_decode_cache *cache,
+    const struct decoded_name_string *decoded
+)
+{
+    uacpi_u32 slot;
+
+    slot = decode_cache_slot(cache, decoded->key);
+    while (cache->entries[slot].key != 0)
+        slot = (slot + 1) & cache->capacity_mask;
+
+    cache->entries[slot] = *decoded;
+    cache->count++;
+}
+
+static uacpi_bool decode_cache_grow(uacpi_control_method *method)
+{
+    struct uacpi_method_decode_cache *cache = method->decode_cache;
+    struct decoded_name_string *old_entries;
+    uacpi_u32 i, old_capacity, new_capacity = DECODE_CACHE_INITIAL_CAPACITY;
+
+    if (cache == UACPI_NULL) {
+        cache = uacpi_kernel_calloc(1, sizeof(*cache));
+        if (uacpi_unlikely(cache == UACPI_NULL))
+            return UACPI_FALSE;
+
+        method->decode_cache = cache;
+        old_capacity = 0;
+    } else {
+        old_capacity = cache->capacity_mask + 1;
+        new_capacity = old_capacity * 2;
+    }
+
+    old_entries = cache->entries;
+    cache->entries = uacpi_kernel_calloc(
+        new_capacity, sizeof(*cache->entries)
+    );
+    if (uacpi_unlikely(cache->entries == UACPI_NULL)) {
+        cache->entries = old_entries;
+
+        if (old_entries == UACPI_NULL)
+            uacpi_method_decode_cache_free(method);
+        return UACPI_FALSE;
+    }
+
+    cache->capacity_mask = new_capacity - 1;
+    cache->count = 0;
+
+    for (i = 0; i < old_capacity; ++i) {
+        if (old_entries[i].key != 0)
+            decode_cache_do_insert(cache, &old_entries[i]);
+    }
+
+    if (old_entries != UACPI_NULL)
+        uacpi_free(old_entries, sizeof(*old_entries) * old_capacity);
+
+    return UACPI_TRUE;
+}
+
+static void decode_cache_insert(
+    uacpi_control_method *method, const struct decoded_name_string *decoded
+)
+{
+    struct uacpi_method_decode_cache *cache = method->decode_cache;
+
+    /*
+     * Table-level code is executed exactly once, don't waste memory caching
+     * anything for it.
+     */
+    if (method->named_objects_persist)
+        return;
+
+    // Keep the load factor at or below 50%
+    if (cache == UACPI_NULL ||
+        (cache->count + 1) * 2 > cache->capacity_mask + 1) {
+        // The cache is an optimization, simply skip it if we're out of memory
+        if (uacpi_unlikely(!decode_cache_grow(method)))
+            return;
+
+        cache = method->decode_cache;
+    }
+
+    decode_cache_do_insert(cache, decoded);
+}
+
+static uacpi_status decode_name_string(
+    struct call_frame *frame, struct decoded_name_string *out_decoded
+)
+{
+    uacpi_status ret;
+    uacpi_u8 *base_cursor, *cursor;
+    uacpi_size bytes_left, namesegs = 0, prefix_bytes, i;
     uacpi_char prev_char = 0;
-    uacpi_bool just_one_nameseg = UACPI_TRUE;
+    uacpi_u8 flags = DECODED_NAME_STRING_JUST_ONE_NAMESEG;
 
     bytes_left = call_frame_code_bytes_left(frame);
     cursor = call_frame_cursor(frame);
+    base_cursor = cursor;
 
     for (;;) {
         if (uacpi_unlikely(bytes_left == 0))
@@ -522,14 +954,7 @@ static uacpi_status resolve_name_string(
             if (prev_char == '^')
                 return UACPI_STATUS_AML_INVALID_NAMESTRING;
 
-            cur_node = uacpi_namespace_root();
-            break;
-        case '^':
-            // Tried to go behind root
-            if (uacpi_unlikely(cur_node == uacpi_namespace_root()))
-                return UACPI_STATUS_AML_INVALID_NAMESTRING;
-
-            cur_node = cur_node->parent;
+            flags |= DECODED_NAME_STRING_ROOT;
             break;
         default:
             break;
@@ -540,7 +965,7 @@ static uacpi_status resolve_name_string(
         switch (prev_char) {
         case '^':
         case '\\':
-            just_one_nameseg = UACPI_FALSE;
+            flags &= ~DECODED_NAME_STRING_JUST_ONE_NAMESEG;
             cursor++;
             bytes_left--;
             break;
@@ -552,6 +977,8 @@ static uacpi_status resolve_name_string(
             break;
     }
 
+    prefix_bytes = cursor - base_cursor;
+
     // At least a NullName byte is expected here
     if (uacpi_unlikely(bytes_left == 0))
         return UACPI_STATUS_AML_INVALID_NAMESTRING;
@@ -561,7 +988,7 @@ static uacpi_status resolve_name_string(
     {
     case UACPI_DUAL_NAME_PREFIX:
         namesegs = 2;
-        just_one_nameseg = UACPI_FALSE;
+        flags &= ~DECODED_NAME_STRING_JUST_ONE_NAMESEG;
         break;
     case UACPI_MULTI_NAME_PREFIX:
         if (uacpi_unlikely(bytes_left == 0))
@@ -575,14 +1002,11 @@ static uacpi_status resolve_name_string(
 
         cursor++;
         bytes_left--;
-        just_one_nameseg = UACPI_FALSE;
+        flags &= ~DECODED_NAME_STRING_JUST_ONE_NAMESEG;
         break;
     case UACPI_NULL_NAME:
-        if (behavior == RESOLVE_CREATE_LAST_NAMESEG_FAIL_IF_EXISTS ||
-            just_one_nameseg)
-            return UACPI_STATUS_AML_INVALID_NAMESTRING;
-
-        goto out;
+        flags |= DECODED_NAME_STRING_NULL_NAME;
+        break;
     default:
         /*
          * Might be an invalid byte, but assume single nameseg for now,
@@ -597,13 +1021,84 @@ static uacpi_status resolve_name_string(
     if (uacpi_unlikely((namesegs * 4) > bytes_left))
         return UACPI_STATUS_AML_INVALID_NAMESTRING;
 
-    for (; namesegs; cursor += 4, namesegs--) {
+    for (i = 0; i < namesegs; ++i) {
         uacpi_object_name name;
 
-        ret = parse_nameseg(cursor, &name);
+        ret = parse_nameseg(cursor + i * 4, &name);
+        if (uacpi_unlikely_error(ret))
+            return ret;
+    }
+
+    out_decoded->key = frame->code_offset + 1;
+    out_decoded->segs_offset = cursor - base_cursor;
+    out_decoded->length = out_decoded->segs_offset + namesegs * 4;
+    out_decoded->parent_prefixes = prefix_bytes;
+    if (flags & DECODED_NAME_STRING_ROOT)
+        out_decoded->parent_prefixes = 0;
+    out_decoded->num_segs = namesegs;
+    out_decoded->flags = flags;
+    return UACPI_STATUS_OK;
+}
+
+enum resolve_behavior {
+    RESOLVE_CREATE_LAST_NAMESEG_FAIL_IF_EXISTS,
+    RESOLVE_FAIL_IF_DOESNT_EXIST,
+};
+
+static uacpi_status resolve_name_string(
+    struct call_frame *frame,
+    enum resolve_behavior behavior,
+    struct uacpi_namespace_node **out_node
+)
+{
+    uacpi_status ret = UACPI_STATUS_OK;
+    struct decoded_name_string local_decoded, *decoded;
+    uacpi_u8 *cursor;
+    uacpi_size namesegs, i;
+    struct uacpi_namespace_node *parent, *cur_node = frame->cur_scope;
+    uacpi_bool just_one_nameseg;
+
+    decoded = decode_cache_lookup(frame->method, frame->code_offset);
+    if (decoded == UACPI_NULL) {
+        ret = decode_name_string(frame, &local_decoded);
         if (uacpi_unlikely_error(ret))
             return ret;
 
+        decoded = &local_decoded;
+        decode_cache_insert(frame->method, decoded);
+    }
+
+    cursor = call_frame_cursor(frame);
+
+    if (decoded->flags & DECODED_NAME_STRING_ROOT)
+        cur_node = uacpi_namespace_root();
+
+    for (i = 0; i < decoded->parent_prefixes; ++i) {
+        // Tried to go behind root
+        if (uacpi_unlikely(cur_node == uacpi_namespace_root()))
+            return UACPI_STATUS_AML_INVALID_NAMESTRING;
+
+        cur_node = cur_node->parent;
+    }
+
+    just_one_nameseg = decoded->flags & DECODED_NAME_STRING_JUST_ONE_NAMESEG;
+
+    if (decoded->flags & DECODED_NAME_STRING_NULL_NAME) {
+        if (behavior == RESOLVE_CREATE_LAST_NAMESEG_FAIL_IF_EXISTS ||
+            just_one_nameseg)
+            return UACPI_STATUS_AML_INVALID_NAMESTRING;
+
+        goto out;
+    }
+
+    cursor += decoded->segs_offset;
+
+    for (namesegs = decoded->num_segs; namesegs; cursor += 4, namesegs--) {
+        uacpi_object_name name;
+
+        // Already validated by decode_name_string()
+        uacpi_memcpy(&name.id, cursor, 4);
+
         parent = cur_node;
         cur_node = uacpi_namespace_node_find_sub_node(parent, name);
 
@@ -642,8 +1137,7 @@ static uacpi_status resolve_name_string(
     }
 
 out:
-    cursor += namesegs * 4;
-    frame->code_offset = cursor - frame->method->code;
+    frame->code_offset += decoded->length;
     *out_node = cur_node;
     return ret;
 }
@@ -1354,6 +1848,12 @@ static uacpi_status handle_load_table(struct execution_context *ctx)
         );
         if (uacpi_unlikely(root_node == UACPI_NULL))
             return table_id_error("LoadTable", "RootPathString", root_path);
+
+        /*
+         * Interpreter items don't hold node references, we're running with
+         * the interpreter lock held so nothing can uninstall it under us.
+         */
+        uacpi_namespace_node_release(root_node);
     } else {
         root_node = uacpi_namespace_root();
     }
@@ -1376,6 +1876,8 @@ static uacpi_status handle_load_table(struct execution_context *ctx)
         param_item->obj = param_node->object;
         uacpi_object_ref(param_item->obj);
         param_item->type = ITEM_OBJECT;
+
+        uacpi_namespace_node_release(param_node);
     }
 
     ret = uacpi_table_find(&table_id, &table);
@@ -3085,6 +3587,7 @@ static uacpi_status handle_stall_or_sleep(struct execution_context *ctx)
 {
     struct op_context *op_ctx = ctx->cur_op_ctx;
     uacpi_u64 time;
+    uacpi_u32 depth;
 
     time = item_array_at(&op_ctx->items, 0)->obj->integer;
 
@@ -3096,7 +3599,9 @@ static uacpi_status handle_stall_or_sleep(struct execution_context *ctx)
         if (time > 2000)
             time = 2000;
 
+        depth = uacpi_interpreter_suspend();
         uacpi_kernel_sleep(time);
+        uacpi_interpreter_resume(depth);
     } else {
         // Spec says this must evaluate to a ByteData
         time &= 0xFF;
@@ -3493,13 +3998,16 @@ static uacpi_status handle_event_ctl(struct execution_context *ctx)
         break;
     case UACPI_AML_OP_WaitOp: {
         uacpi_u64 timeout;
+        uacpi_u32 depth;
         uacpi_bool ret;
 
         timeout = item_array_at(&op_ctx->items, 1)->obj->integer;
         if (timeout > 0xFFFF)
             timeout = 0xFFFF;
 
+        depth = uacpi_interpreter_suspend();
         ret = uacpi_kernel_wait_for_event(obj->event->handle, timeout);
+        uacpi_interpreter_resume(depth);
 
         /*
          * The return value here is inverted, we return 0 for success and Ones
@@ -4087,6 +4595,12 @@ static uacpi_status push_new_frame(struct execution_context *ctx,
     if (uacpi_unlikely(*out_frame == UACPI_NULL))
         return UACPI_STATUS_OUT_OF_MEMORY;
 
+    op_context_array_set_allocator(&(*out_frame)->pending_ops, &ctx->allocator);
+    code_block_array_set_allocator(&(*out_frame)->code_blocks, &ctx->allocator);
+    temp_namespace_node_array_set_allocator(
+        &(*out_frame)->temp_nodes, &ctx->allocator
+    );
+
     /*
      * Allocating a new frame might have reallocated the dynamic buffer so our
      * execution_context members might now be pointing to freed memory.
@@ -4293,6 +4807,7 @@ static uacpi_status push_op(struct execution_context *ctx)
     if (op_ctx == UACPI_NULL)
         return UACPI_STATUS_OUT_OF_MEMORY;
 
+    item_array_set_allocator(&op_ctx->items, &ctx->allocator);
     op_ctx->op = ctx->cur_op;
     refresh_ctx_pointers(ctx);
     return UACPI_STATUS_OK;
@@ -5635,6 +6150,7 @@ static void execution_context_release(struct execution_context *ctx)
 
     call_frame_array_clear(&ctx->call_stack);
     held_mutexes_array_clear(&ctx->held_mutexes);
+    eval_arena_release(&ctx->arena);
     uacpi_free(ctx, sizeof(*ctx));
 }
 
@@ -5650,6 +6166,18 @@ uacpi_status uacpi_execute_control_method(
     if (uacpi_unlikely(ctx == UACPI_NULL))
         return UACPI_STATUS_OUT_OF_MEMORY;
 
+    ret = uacpi_interpreter_enter();
+    if (uacpi_unlikely_error(ret)) {
+        uacpi_free(ctx, sizeof(*ctx));
+        return ret;
+    }
+
+    ctx->allocator.alloc = eval_arena_alloc;
+    ctx->allocator.free = eval_arena_free;
+    ctx->allocator.ctx = &ctx->arena;
+    call_frame_array_set_allocator(&ctx->call_stack, &ctx->allocator);
+    held_mutexes_array_set_allocator(&ctx->held_mutexes, &ctx->allocator);
+
     if (out_obj != UACPI_NULL) {
         ctx->ret = uacpi_create_object(UACPI_OBJECT_UNINITIALIZED);
         if (uacpi_unlikely(ctx->ret == UACPI_NULL)) {
@@ -5723,6 +6251,7 @@ out:
     }
 
     execution_context_release(ctx);
+    uacpi_interpreter_exit();
     return ret;
 }
 
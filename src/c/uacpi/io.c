@@ -29,6 +29,7 @@
 #include <uacpi/internal/opregion.h>
 #include <uacpi/internal/utilities.h>
 #include <uacpi/internal/mutex.h>
+#include <uacpi/internal/interpreter.h>
 
 uacpi_size uacpi_round_up_bits_to_bytes(uacpi_size bit_length)
 {
@@ -208,6 +209,7 @@ static uacpi_status dispatch_field_io(
     uacpi_address_space_handler *handler;
     uacpi_u64 offset_end;
 
+    uacpi_u32 depth;
     uacpi_region_rw_data data = {
         .byte_width = byte_width,
         .offset = offset,
@@ -253,7 +255,17 @@ static uacpi_status dispatch_field_io(
                               byte_width, data.value);
     }
 
+    /*
+     * Host handlers (EC, SMBus, ...) may block for a long time, let other AML
+     * run meanwhile. Our reference keeps the handler alive even if it gets
+     * uninstalled before the callback returns.
+     */
+    uacpi_shareable_ref(handler);
+    depth = uacpi_interpreter_suspend();
     ret = handler->callback(op, &data);
+    uacpi_interpreter_resume(depth);
+    uacpi_address_space_handler_unref(handler);
+
     if (uacpi_unlikely_error(ret))
         return ret;
 
@@ -273,21 +285,6 @@ static uacpi_status access_field_unit(
 {
     uacpi_status ret = UACPI_STATUS_OK;
     uacpi_namespace_node *region_node;
-    uacpi_mutex *gl = UACPI_NULL;
-
-    if (field->lock_rule) {
-        uacpi_namespace_node *gl_node;
-        uacpi_object *obj;
-
-        gl_node = uacpi_namespace_get_predefined(UACPI_PREDEFINED_NAMESPACE_GL);
-        obj = uacpi_namespace_node_get_object(gl_node);
-
-        if (uacpi_likely(obj != UACPI_NULL && obj->type == UACPI_OBJECT_MUTEX))
-            gl = obj->mutex;
-
-        if (uacpi_unlikely(!uacpi_acquire_aml_mutex(gl, 0xFFFF)))
-            return UACPI_STATUS_INTERNAL_ERROR;
-    }
 
     switch (field->kind) {
     case UACPI_FIELD_UNIT_KIND_BANK:
@@ -304,7 +301,7 @@ static uacpi_status access_field_unit(
             field->index, &offset, sizeof(offset)
         );
         if (uacpi_unlikely_error(ret))
-            goto out;
+            return ret;
 
         switch (op) {
         case UACPI_REGION_OP_READ:
@@ -316,8 +313,7 @@ static uacpi_status access_field_unit(
                 field->data, in_out, field->access_width_bytes
             );
         default:
-            ret = UACPI_STATUS_INVALID_ARGUMENT;
-            goto out;
+            return UACPI_STATUS_INVALID_ARGUMENT;
         }
 
     default:
@@ -326,16 +322,46 @@ static uacpi_status access_field_unit(
     }
 
     if (uacpi_unlikely_error(ret))
-        goto out;
+        return ret;
 
-    ret = dispatch_field_io(
+    return dispatch_field_io(
         region_node, offset, field->access_width_bytes, op, in_out
     );
+}
 
-out:
+/*
+ * Fields with a lock rule are accessed with the global lock held. It's taken
+ * once for the entire field rather than for every access width sized chunk
+ * of it, and bank/index selection done on behalf of the field happens under
+ * the same hold. Fields accessed while it's already held by this thread, e.g.
+ * after an explicit Acquire(\_GL), only bump the recursion depth.
+ */
+static uacpi_status field_lock(uacpi_field_unit *field, uacpi_mutex **out_gl)
+{
+    uacpi_namespace_node *gl_node;
+    uacpi_object *obj;
+
+    *out_gl = UACPI_NULL;
+    if (!field->lock_rule)
+        return UACPI_STATUS_OK;
+
+    gl_node = uacpi_namespace_get_predefined(UACPI_PREDEFINED_NAMESPACE_GL);
+    obj = uacpi_namespace_node_get_object(gl_node);
+
+    if (uacpi_unlikely(obj == UACPI_NULL || obj->type != UACPI_OBJECT_MUTEX))
+        return UACPI_STATUS_INTERNAL_ERROR;
+
+    if (uacpi_unlikely(!uacpi_acquire_aml_mutex(obj->mutex, 0xFFFF)))
+        return UACPI_STATUS_INTERNAL_ERROR;
+
+    *out_gl = obj->mutex;
+    return UACPI_STATUS_OK;
+}
+
+static void field_unlock(uacpi_mutex *gl)
+{
     if (gl != UACPI_NULL)
         uacpi_release_aml_mutex(gl);
-    return ret;
 }
 
 static uacpi_status do_read_misaligned_field_unit(
@@ -389,7 +415,7 @@ static uacpi_status do_read_misaligned_field_unit(
     return UACPI_STATUS_OK;
 }
 
-uacpi_status uacpi_read_field_unit(
+static uacpi_status do_read_field_unit(
     uacpi_field_unit *field, void *dst, uacpi_size size
 )
 {
@@ -426,7 +452,23 @@ uacpi_status uacpi_read_field_unit(
     return do_read_misaligned_field_unit(field, dst, size);
 }
 
-uacpi_status uacpi_write_field_unit(
+uacpi_status uacpi_read_field_unit(
+    uacpi_field_unit *field, void *dst, uacpi_size size
+)
+{
+    uacpi_status ret;
+    uacpi_mutex *gl;
+
+    ret = field_lock(field, &gl);
+    if (uacpi_unlikely_error(ret))
+        return ret;
+
+    ret = do_read_field_unit(field, dst, size);
+    field_unlock(gl);
+    return ret;
+}
+
+static uacpi_status do_write_field_unit(
     uacpi_field_unit *field, const void *src, uacpi_size size
 )
 {
@@ -491,6 +533,22 @@ uacpi_status uacpi_write_field_unit(
     return UACPI_STATUS_OK;
 }
 
+uacpi_status uacpi_write_field_unit(
+    uacpi_field_unit *field, const void *src, uacpi_size size
+)
+{
+    uacpi_status ret;
+    uacpi_mutex *gl;
+
+    ret = field_lock(field, &gl);
+    if (uacpi_unlikely_error(ret))
+        return ret;
+
+    ret = do_write_field_unit(field, src, size);
+    field_unlock(gl);
+    return ret;
+}
+
 static uacpi_u8 gas_get_access_bit_width(const struct acpi_gas *gas)
 {
     /*
@@ -551,15 +609,18 @@ static uacpi_status gas_validate(
 
     if (gas->address_space_id != UACPI_ADDRESS_SPACE_SYSTEM_IO &&
         gas->address_space_id != UACPI_ADDRESS_SPACE_SYSTEM_MEMORY) {
-        uacpi_warn("unsupported GAS address space '%s' (%d)\n",
-                   uacpi_address_space_to_string(gas->address_space_id),
-                   gas->address_space_id);
+        uacpi_warn_ratelimited(
+            "unsupported GAS address space '%s' (%d)\n",
+            uacpi_address_space_to_string(gas->address_space_id),
+            gas->address_space_id
+        );
         return UACPI_STATUS_UNIMPLEMENTED;
     }
 
     if (gas->access_size > 4) {
-        uacpi_warn("unsupported GAS access size %d\n",
-                   gas->access_size);
+        uacpi_warn_ratelimited(
+            "unsupported GAS access size %d\n", gas->access_size
+        );
         return UACPI_STATUS_UNIMPLEMENTED;
     }
 
@@ -570,7 +631,7 @@ static uacpi_status gas_validate(
         *access_bit_width, uacpi_size
     );
     if (total_width > 64) {
-        uacpi_warn(
+        uacpi_warn_ratelimited(
             "GAS register total width is too large: %zu\n", total_width
         );
         return UACPI_STATUS_UNIMPLEMENTED;
@@ -28,8 +28,87 @@
 #include <uacpi/internal/log.h>
 #include <uacpi/internal/registers.h>
 #include <uacpi/internal/context.h>
+#include <uacpi/internal/interpreter.h>
 #include <uacpi/kernel_api.h>
 
+#ifndef UACPI_GLOBAL_LOCK_MAX_SPINS
+    /*
+     * Upper bound on the number of 1us attempts made at the global lock mutex
+     * before going to sleep on it. The actual number adapts to how long the
+     * lock has recently been held by others, and shrinks if spinning keeps
+     * ending up having to block anyway.
+     */
+    #define UACPI_GLOBAL_LOCK_MAX_SPINS 64
+#endif
+
+/*
+ * All of these are only ever updated with the global lock mutex held, the
+ * firmware wait counter with the global lock spinlock held instead.
+ */
+static uacpi_global_lock_stats g_global_lock_stats;
+static uacpi_u32 g_global_lock_spin_limit = UACPI_GLOBAL_LOCK_MAX_SPINS / 4;
+
+static uacpi_bool acquire_global_lock_mutex(uacpi_u16 timeout)
+{
+    uacpi_handle mtx = g_uacpi_rt_ctx.global_lock_mutex;
+    uacpi_u32 spins, limit;
+    uacpi_i32 delta;
+    uacpi_bool did_acquire;
+
+    if (uacpi_kernel_acquire_mutex(mtx, 0)) {
+        UACPI_TRACE_MUTEX_ACQUISITION(mtx);
+        g_global_lock_stats.uncontended++;
+        return UACPI_TRUE;
+    }
+
+    if (timeout == 0) {
+        UACPI_TRACE_MUTEX_ACQUISITION_TIMEOUT(mtx, timeout);
+        return UACPI_FALSE;
+    }
+
+    /*
+     * Holders of the global lock only ever do a few register accesses or a
+     * short AML sequence, so it's usually cheaper to wait for them actively
+     * than to go through the scheduler.
+     */
+    limit = uacpi_atomic_load32(&g_global_lock_spin_limit);
+
+    for (spins = 1; spins <= limit; ++spins) {
+        uacpi_kernel_stall(1);
+
+        if (!uacpi_kernel_acquire_mutex(mtx, 0))
+            continue;
+
+        UACPI_TRACE_MUTEX_ACQUISITION(mtx);
+        g_global_lock_stats.spun++;
+
+        // Move the limit towards twice what it took this time
+        delta = ((uacpi_i32)(spins * 2) - (uacpi_i32)limit) / 8;
+        limit = UACPI_MAX((uacpi_i32)limit + delta, 1);
+        uacpi_atomic_store32(
+            &g_global_lock_spin_limit,
+            UACPI_MIN(limit, UACPI_GLOBAL_LOCK_MAX_SPINS)
+        );
+        return UACPI_TRUE;
+    }
+
+    UACPI_MUTEX_ACQUIRE_WITH_TIMEOUT(mtx, timeout, did_acquire);
+    if (!did_acquire)
+        return UACPI_FALSE;
+
+    // Spinning was a waste of time, do less of it going forward
+    g_global_lock_stats.blocked++;
+    uacpi_atomic_store32(
+        &g_global_lock_spin_limit, UACPI_MAX(limit - limit / 4, 1)
+    );
+    return UACPI_TRUE;
+}
+
+void uacpi_global_lock_get_stats(uacpi_global_lock_stats *out_stats)
+{
+    uacpi_memcpy(out_stats, &g_global_lock_stats, sizeof(*out_stats));
+}
+
 #if UACPI_REDUCED_HARDWARE == 0
 
 #define GLOBAL_LOCK_PENDING (1 << 0)
@@ -101,6 +180,7 @@ static uacpi_status uacpi_acquire_global_lock_from_firmware(void)
             break;
 
         g_uacpi_rt_ctx.global_lock_pending = UACPI_TRUE;
+        g_global_lock_stats.firmware_waits++;
         uacpi_trace(
             "global lock is owned by firmware, waiting for a release "
             "notification...\n"
@@ -155,9 +235,7 @@ uacpi_status uacpi_acquire_global_lock(uacpi_u16 timeout, uacpi_u32 *out_seq)
     if (uacpi_unlikely(out_seq == UACPI_NULL))
         return UACPI_STATUS_INVALID_ARGUMENT;
 
-    UACPI_MUTEX_ACQUIRE_WITH_TIMEOUT(
-        g_uacpi_rt_ctx.global_lock_mutex, timeout, did_acquire
-    );
+    did_acquire = acquire_global_lock_mutex(timeout);
     if (!did_acquire)
         return UACPI_STATUS_TIMEOUT;
 
@@ -198,10 +276,31 @@ uacpi_bool uacpi_this_thread_owns_aml_mutex(uacpi_mutex *mutex)
     return id == uacpi_kernel_get_thread_id();
 }
 
+static uacpi_bool do_acquire_aml_mutex(uacpi_mutex *mutex, uacpi_u16 timeout)
+{
+    uacpi_bool did_acquire;
+
+    if (mutex->handle != g_uacpi_rt_ctx.global_lock_mutex) {
+        UACPI_MUTEX_ACQUIRE_WITH_TIMEOUT(mutex->handle, timeout, did_acquire);
+        return did_acquire;
+    }
+
+    if (!acquire_global_lock_mutex(timeout))
+        return UACPI_FALSE;
+
+    if (uacpi_unlikely_error(uacpi_acquire_global_lock_from_firmware())) {
+        UACPI_MUTEX_RELEASE(mutex->handle);
+        return UACPI_FALSE;
+    }
+
+    return UACPI_TRUE;
+}
+
 uacpi_bool uacpi_acquire_aml_mutex(uacpi_mutex *mutex, uacpi_u16 timeout)
 {
     uacpi_thread_id this_id;
     uacpi_bool did_acquire;
+    uacpi_u32 depth;
 
     this_id = uacpi_kernel_get_thread_id();
     if (UACPI_ATOMIC_LOAD_THREAD_ID(&mutex->owner) == this_id) {
@@ -214,23 +313,26 @@ uacpi_bool uacpi_acquire_aml_mutex(uacpi_mutex *mutex, uacpi_u16 timeout)
         }
 
         mutex->depth++;
+        if (mutex->handle == g_uacpi_rt_ctx.global_lock_mutex)
+            g_global_lock_stats.recursive++;
         return UACPI_TRUE;
     }
 
-    UACPI_MUTEX_ACQUIRE_WITH_TIMEOUT(mutex->handle, timeout, did_acquire);
+    /*
+     * The holder might be a method that's currently blocked with the
+     * interpreter lock dropped, so never wait for it with the interpreter
+     * lock held, as it would never be able to get back in and release.
+     */
+    did_acquire = do_acquire_aml_mutex(mutex, 0);
+    if (!did_acquire && timeout != 0) {
+        depth = uacpi_interpreter_suspend();
+        did_acquire = do_acquire_aml_mutex(mutex, timeout);
+        uacpi_interpreter_resume(depth);
+    }
+
     if (!did_acquire)
         return UACPI_FALSE;
 
-    if (mutex->handle == g_uacpi_rt_ctx.global_lock_mutex) {
-        uacpi_status ret;
-
-        ret = uacpi_acquire_global_lock_from_firmware();
-        if (uacpi_unlikely_error(ret)) {
-            UACPI_MUTEX_RELEASE(mutex->handle);
-            return UACPI_FALSE;
-        }
-    }
-
     UACPI_ATOMIC_STORE_THREAD_ID(&mutex->owner, this_id);
     mutex->depth = 1;
     return UACPI_TRUE;
@@ -32,6 +32,7 @@
 #include <uacpi/internal/log.h>
 #include <uacpi/internal/utilities.h>
 #include <uacpi/kernel_api.h>
+#include <uacpi/platform/atomic.h>
 
 #define UACPI_REV_VALUE 2
 #define UACPI_OS_VALUE "Microsoft Windows NT"
@@ -123,23 +124,490 @@ static uacpi_object *make_object_for_predefined(
     return obj;
 }
 
-static void free_namespace_node(uacpi_handle handle)
+struct uacpi_namespace_child_index {
+    uacpi_u32 capacity_shift;
+    uacpi_u32 count;
+    uacpi_namespace_node **slots;
+    struct uacpi_namespace_child_index *retired_next;
+    uacpi_u32 retired_epoch;
+};
+
+#define CHILD_INDEX_MIN_CAPACITY_SHIFT 6
+
+static inline uacpi_u32 child_index_capacity(
+    const struct uacpi_namespace_child_index *index
+)
 {
-    uacpi_namespace_node *node = handle;
+    return 1u << index->capacity_shift;
+}
+
+static inline uacpi_u32 child_index_hash(
+    const struct uacpi_namespace_child_index *index, uacpi_object_name name
+)
+{
+    // Fibonacci hashing, the top bits of the product are the best mixed
+    return (uacpi_u32)(name.id * 0x9E3779B1u) >> (32 - index->capacity_shift);
+}
+
+/*
+ * Namespace lookups may run concurrently with each other and with writers.
+ *
+ * Writers (node install/uninstall, which also maintain the child index) are
+ * serialized by namespace_write_mutex and keep namespace_seq odd for the
+ * duration of a modification. Readers never take the mutex, a lookup is
+ * simply retried if namespace_seq was odd or has changed while it ran, which
+ * means it raced with a writer and might have observed a half-updated index.
+ *
+ * A reader might still be looking at a node or a child index that was just
+ * unlinked, so those are never freed right away. Instead they're tagged with
+ * the current epoch and put on a retire list.
+ *
+ * Read-side critical sections are counted in one of two slots, picked by the
+ * epoch they started in. The epoch is only allowed to advance once the slot
+ * of the previous epoch has drained, so two advances past the epoch something
+ * was retired in mean every reader that could have seen it is gone. Readers
+ * that keep arriving in the meantime go to the other slot, which means a
+ * steady stream of lookups and walks can't hold reclamation back forever.
+ */
+static uacpi_handle namespace_write_mutex;
+static uacpi_u32 namespace_seq;
+static uacpi_u32 namespace_epoch;
+static uacpi_u32 namespace_readers[2];
+static uacpi_namespace_node *retired_nodes;
+static struct uacpi_namespace_child_index *retired_indices;
+
+static uacpi_u32 atomic_add32(uacpi_u32 *ptr, uacpi_u32 delta)
+{
+    uacpi_u32 value;
+
+    value = uacpi_atomic_load32(ptr);
+    while (!uacpi_atomic_cmpxchg32(ptr, &value, value + delta));
+
+    return value + delta;
+}
+
+/*
+ * This is a cmpxchg and not a plain load so that it can't be reordered
+ * before the stores that unlinked whatever is being retired, or before the
+ * reader count update of a read-side critical section that is starting.
+ */
+static uacpi_u32 atomic_read32(uacpi_u32 *ptr)
+{
+    uacpi_u32 value = 0;
+
+    uacpi_atomic_cmpxchg32(ptr, &value, 0);
+    return value;
+}
+
+static void namespace_try_advance_epoch(void)
+{
+    uacpi_u32 epoch;
+
+    epoch = atomic_read32(&namespace_epoch);
+
+    // Readers that started in the previous epoch are still around
+    if (atomic_read32(&namespace_readers[(epoch + 1) & 1]) != 0)
+        return;
+
+    uacpi_atomic_cmpxchg32(&namespace_epoch, &epoch, epoch + 1);
+}
+
+static uacpi_bool namespace_grace_period_elapsed(
+    uacpi_u32 epoch, uacpi_u32 retired_epoch
+)
+{
+    return epoch - retired_epoch >= 2;
+}
+
+static uacpi_status namespace_write_lock(void)
+{
+    if (namespace_write_mutex != UACPI_NULL)
+        UACPI_MUTEX_ACQUIRE(namespace_write_mutex);
+
+    return UACPI_STATUS_OK;
+}
+
+static void namespace_write_unlock(void)
+{
+    if (namespace_write_mutex != UACPI_NULL)
+        UACPI_MUTEX_RELEASE(namespace_write_mutex);
+}
+
+/*
+ * Readers retry for as long as namespace_seq is odd, so the window between
+ * these two must be kept as short as possible. In particular, nothing in it
+ * may allocate or otherwise call into the host.
+ */
+static void namespace_seq_begin(void)
+{
+    atomic_add32(&namespace_seq, 1);
+}
+
+static void namespace_seq_end(void)
+{
+    atomic_add32(&namespace_seq, 1);
+}
+
+static uacpi_status namespace_write_begin(void)
+{
+    uacpi_status ret;
+
+    ret = namespace_write_lock();
+    if (uacpi_unlikely_error(ret))
+        return ret;
+
+    namespace_seq_begin();
+    return UACPI_STATUS_OK;
+}
+
+static void namespace_write_end(void)
+{
+    namespace_seq_end();
+    namespace_write_unlock();
+}
+
+static uacpi_u32 namespace_read_begin(void)
+{
+    return uacpi_atomic_load32(&namespace_seq);
+}
+
+static uacpi_bool namespace_read_retry(uacpi_u32 seq)
+{
+    return (seq & 1) || uacpi_atomic_load32(&namespace_seq) != seq;
+}
+
+static void push_retired_node(uacpi_namespace_node *node)
+{
+    uacpi_namespace_node *head;
+
+    head = uacpi_atomic_load_ptr(&retired_nodes);
+    do {
+        node->retired_next = head;
+    } while (!uacpi_atomic_cmpxchg_ptr(&retired_nodes, &head, node));
+}
+
+static void push_retired_index(struct uacpi_namespace_child_index *index)
+{
+    struct uacpi_namespace_child_index *head;
+
+    head = uacpi_atomic_load_ptr(&retired_indices);
+    do {
+        index->retired_next = head;
+    } while (!uacpi_atomic_cmpxchg_ptr(&retired_indices, &head, index));
+}
+
+static void reclaim_node(uacpi_namespace_node *node);
+
+static void child_index_free(struct uacpi_namespace_child_index *index)
+{
+    if (index == UACPI_NULL)
+        return;
+
+    uacpi_free(
+        index->slots, sizeof(*index->slots) * child_index_capacity(index)
+    );
+    uacpi_free(index, sizeof(*index));
+}
+
+static void reclaim_retired(void)
+{
+    uacpi_namespace_node *node, *next_node;
+    struct uacpi_namespace_child_index *index, *next_index;
+    uacpi_u32 epoch;
+
+    /*
+     * Both of these only succeed if neither slot has any readers, in which
+     * case everything that's been retired so far can go right away.
+     */
+    namespace_try_advance_epoch();
+    namespace_try_advance_epoch();
+    epoch = atomic_read32(&namespace_epoch);
+
+    node = uacpi_atomic_load_ptr(&retired_nodes);
+    while (!uacpi_atomic_cmpxchg_ptr(&retired_nodes, &node, UACPI_NULL));
+
+    index = uacpi_atomic_load_ptr(&retired_indices);
+    while (!uacpi_atomic_cmpxchg_ptr(&retired_indices, &index, UACPI_NULL));
+
+    for (; node != UACPI_NULL; node = next_node) {
+        next_node = node->retired_next;
+
+        if (namespace_grace_period_elapsed(epoch, node->retired_epoch))
+            reclaim_node(node);
+        else
+            push_retired_node(node);
+    }
+
+    for (; index != UACPI_NULL; index = next_index) {
+        next_index = index->retired_next;
+
+        if (namespace_grace_period_elapsed(epoch, index->retired_epoch))
+            child_index_free(index);
+        else
+            push_retired_index(index);
+    }
+}
+
+static void maybe_reclaim_retired(void)
+{
+    if (uacpi_atomic_load_ptr(&retired_nodes) == UACPI_NULL &&
+        uacpi_atomic_load_ptr(&retired_indices) == UACPI_NULL)
+        return;
+
+    reclaim_retired();
+}
+
+static void retire_node(uacpi_namespace_node *node)
+{
+    node->retired_epoch = atomic_read32(&namespace_epoch);
+    push_retired_node(node);
+    reclaim_retired();
+}
+
+/*
+ * Indices are only ever retired from inside the seq window, so they're
+ * always reclaimed later by the writer once it's done.
+ */
+static void retire_index(struct uacpi_namespace_child_index *index)
+{
+    if (index == UACPI_NULL)
+        return;
+
+    index->retired_epoch = atomic_read32(&namespace_epoch);
+    push_retired_index(index);
+}
+
+uacpi_u32 uacpi_namespace_read_lock(void)
+{
+    uacpi_u32 epoch;
+
+    for (;;) {
+        epoch = uacpi_atomic_load32(&namespace_epoch);
+        atomic_add32(&namespace_readers[epoch & 1], 1);
+
+        /*
+         * If the epoch has advanced before we got counted, someone might
+         * have already seen our slot as empty, back off and try again.
+         */
+        if (atomic_read32(&namespace_epoch) == epoch)
+            return epoch;
+
+        atomic_add32(&namespace_readers[epoch & 1], (uacpi_u32)-1);
+    }
+}
+
+void uacpi_namespace_read_unlock(uacpi_u32 token)
+{
+    // Only the last reader of an epoch can allow it to advance
+    if (atomic_add32(&namespace_readers[token & 1], (uacpi_u32)-1) != 0)
+        return;
+
+    maybe_reclaim_retired();
+}
+
+static void child_index_do_insert(
+    struct uacpi_namespace_child_index *index, uacpi_namespace_node *node
+)
+{
+    uacpi_u32 mask = child_index_capacity(index) - 1;
+    uacpi_u32 slot = child_index_hash(index, node->name);
+
+    while (index->slots[slot] != UACPI_NULL) {
+        /*
+         * Duplicate names under the same parent are never indexed twice,
+         * the node that was installed first wins, which mirrors what a peer
+         * list walk would return.
+         */
+        if (index->slots[slot]->name.id == node->name.id)
+            return;
+
+        slot = (slot + 1) & mask;
+    }
+
+    uacpi_atomic_store_ptr(&index->slots[slot], node);
+    index->count++;
+}
+
+static struct uacpi_namespace_child_index *child_index_alloc(
+    uacpi_u32 capacity_shift
+)
+{
+    struct uacpi_namespace_child_index *index;
+
+    index = uacpi_kernel_alloc(sizeof(*index));
+    if (uacpi_unlikely(index == UACPI_NULL))
+        return index;
+
+    index->capacity_shift = capacity_shift;
+    index->count = 0;
+    index->slots = uacpi_kernel_calloc(
+        child_index_capacity(index), sizeof(*index->slots)
+    );
+    if (uacpi_unlikely(index->slots == UACPI_NULL)) {
+        uacpi_free(index, sizeof(*index));
+        return UACPI_NULL;
+    }
+
+    return index;
+}
+
+static uacpi_bool child_index_needs_rebuild(uacpi_namespace_node *parent)
+{
+    struct uacpi_namespace_child_index *index = parent->child_index;
+
+    if (index == UACPI_NULL)
+        return parent->child_count + 1 >= UACPI_NAMESPACE_CHILD_INDEX_THRESHOLD;
+
+    return (index->count + 1) * 2 > child_index_capacity(index);
+}
 
+/*
+ * Builds a new index for the children of 'parent' plus 'node', which is about
+ * to be installed. Must be called with the write lock held, but outside of
+ * the seq window, the result is published by child_index_insert().
+ */
+static struct uacpi_namespace_child_index *child_index_prepare(
+    uacpi_namespace_node *parent, uacpi_namespace_node *node
+)
+{
+    struct uacpi_namespace_child_index *index;
+    uacpi_namespace_node *child;
+    uacpi_u32 shift = CHILD_INDEX_MIN_CAPACITY_SHIFT;
+
+    if (!child_index_needs_rebuild(parent))
+        return UACPI_NULL;
+
+    // Keep the load factor at or below 50%
+    while ((1u << shift) < (parent->child_count + 1) * 2)
+        shift++;
+
+    index = child_index_alloc(shift);
+    if (uacpi_unlikely(index == UACPI_NULL))
+        return index;
+
+    for (child = parent->child; child != UACPI_NULL; child = child->next)
+        child_index_do_insert(index, child);
+    child_index_do_insert(index, node);
+
+    return index;
+}
+
+static void child_index_insert(
+    uacpi_namespace_node *parent, uacpi_namespace_node *node,
+    struct uacpi_namespace_child_index *prepared
+)
+{
+    struct uacpi_namespace_child_index *index = parent->child_index;
+
+    if (prepared != UACPI_NULL) {
+        uacpi_atomic_store_ptr(&parent->child_index, prepared);
+        retire_index(index);
+        return;
+    }
+
+    if (index == UACPI_NULL)
+        return;
+
+    /*
+     * The index is purely an optimization, if a bigger one couldn't be
+     * allocated simply drop it and let lookups walk the peer list.
+     */
+    if (child_index_needs_rebuild(parent)) {
+        uacpi_atomic_store_ptr(&parent->child_index, UACPI_NULL);
+        retire_index(index);
+        return;
+    }
+
+    child_index_do_insert(index, node);
+}
+
+static void child_index_remove(
+    uacpi_namespace_node *parent, uacpi_namespace_node *node
+)
+{
+    struct uacpi_namespace_child_index *index = parent->child_index;
+    uacpi_namespace_node *peer;
+    uacpi_u32 mask, hole, slot, home;
+
+    if (index == UACPI_NULL)
+        return;
+
+    if (parent->child_count < UACPI_NAMESPACE_CHILD_INDEX_THRESHOLD / 2) {
+        uacpi_atomic_store_ptr(&parent->child_index, UACPI_NULL);
+        retire_index(index);
+        return;
+    }
+
+    mask = child_index_capacity(index) - 1;
+    hole = child_index_hash(index, node->name);
+
+    while (index->slots[hole] != node) {
+        // Not indexed, must be a shadowed duplicate
+        if (index->slots[hole] == UACPI_NULL)
+            return;
+
+        hole = (hole + 1) & mask;
+    }
+
+    uacpi_atomic_store_ptr(&index->slots[hole], UACPI_NULL);
+    index->count--;
+
+    /*
+     * Backward-shift deletion: pull every entry of the probe chain that
+     * follows the hole back into it, unless its home slot lies cyclically
+     * between the hole and its current position.
+     */
+    for (slot = (hole + 1) & mask; index->slots[slot] != UACPI_NULL;
+         slot = (slot + 1) & mask) {
+        home = child_index_hash(index, index->slots[slot]->name);
+
+        if (((slot - home) & mask) < ((slot - hole) & mask))
+            continue;
+
+        uacpi_atomic_store_ptr(&index->slots[hole], index->slots[slot]);
+        uacpi_atomic_store_ptr(&index->slots[slot], UACPI_NULL);
+        hole = slot;
+    }
+
+    // Promote a previously shadowed duplicate, if any
+    for (peer = parent->child; peer != UACPI_NULL; peer = peer->next) {
+        if (peer->name.id == node->name.id) {
+            child_index_do_insert(index, peer);
+            break;
+        }
+    }
+}
+
+static void reclaim_node(uacpi_namespace_node *node)
+{
     if (node->object)
         uacpi_object_unref(node->object);
 
+    child_index_free(node->child_index);
+    uacpi_free(node, sizeof(*node));
+}
+
+static void free_namespace_node(uacpi_handle handle)
+{
+    uacpi_namespace_node *node = handle;
+
     if (uacpi_likely(!uacpi_namespace_node_is_predefined(node))) {
-        uacpi_free(node, sizeof(*node));
+        retire_node(node);
         return;
     }
 
+    if (node->object)
+        uacpi_object_unref(node->object);
+
+    child_index_free(node->child_index);
+
     node->flags = UACPI_NAMESPACE_NODE_PREDEFINED;
     node->object = UACPI_NULL;
     node->parent = UACPI_NULL;
     node->child = UACPI_NULL;
     node->next = UACPI_NULL;
+    node->child_index = UACPI_NULL;
+    node->child_count = 0;
 }
 
 uacpi_status uacpi_initialize_namespace(void)
@@ -148,6 +616,10 @@ uacpi_status uacpi_initialize_namespace(void)
     uacpi_object *obj;
     uacpi_namespace_node *node;
 
+    namespace_write_mutex = uacpi_kernel_create_mutex();
+    if (uacpi_unlikely(namespace_write_mutex == UACPI_NULL))
+        return UACPI_STATUS_OUT_OF_MEMORY;
+
     for (ns = 0; ns <= UACPI_PREDEFINED_NAMESPACE_MAX; ns++) {
         node = &predefined_namespaces[ns];
         uacpi_shareable_init(node);
@@ -236,6 +708,11 @@ void uacpi_deinitialize_namespace(void)
         obj->type = UACPI_OBJECT_DEVICE;
 
     free_namespace_node(uacpi_namespace_root());
+    reclaim_retired();
+
+    if (namespace_write_mutex)
+        uacpi_kernel_free_mutex(namespace_write_mutex);
+    namespace_write_mutex = UACPI_NULL;
 }
 
 uacpi_namespace_node *uacpi_namespace_root(void)
@@ -273,11 +750,19 @@ void uacpi_namespace_node_unref(uacpi_namespace_node *node)
     uacpi_shareable_unref_and_delete_if_last(node, free_namespace_node);
 }
 
+void uacpi_namespace_node_release(uacpi_namespace_node *node)
+{
+    uacpi_namespace_node_unref(node);
+}
+
 uacpi_status uacpi_node_install(
     uacpi_namespace_node *parent,
     uacpi_namespace_node *node
 )
 {
+    struct uacpi_namespace_child_index *index;
+    uacpi_status ret;
+
     if (parent == UACPI_NULL)
         parent = uacpi_namespace_root();
 
@@ -287,18 +772,33 @@ uacpi_status uacpi_node_install(
         return UACPI_STATUS_NAMESPACE_NODE_DANGLING;
     }
 
+    // Must be visible to readers by the time the node is linked
+    node->parent = parent;
+
+    ret = namespace_write_lock();
+    if (uacpi_unlikely_error(ret))
+        return ret;
+
+    index = child_index_prepare(parent, node);
+
+    namespace_seq_begin();
+
     if (parent->child == UACPI_NULL) {
-        parent->child = node;
+        uacpi_atomic_store_ptr(&parent->child, node);
     } else {
         uacpi_namespace_node *prev = parent->child;
 
         while (prev->next != UACPI_NULL)
             prev = prev->next;
 
-        prev->next = node;
+        uacpi_atomic_store_ptr(&prev->next, node);
     }
 
-    node->parent = parent;
+    child_index_insert(parent, node, index);
+    parent->child_count++;
+
+    namespace_write_end();
+    maybe_reclaim_retired();
     return UACPI_STATUS_OK;
 }
 
@@ -360,25 +860,29 @@ void uacpi_node_uninstall(uacpi_namespace_node *node)
      * frees a namespace node that frees an attached object that frees a
      * namespace node as well as potential infinite cycles between a namespace
      * node and an object.
+     *
+     * The node is unlinked first so that nothing is torn down if that
+     * fails. Only then is the object detached, which happens outside of the
+     * write section because detaching an operation region may run _REG,
+     * which in turn may install and uninstall nodes of its own.
      */
-    object = uacpi_namespace_node_get_object(node);
-    if (object != UACPI_NULL) {
-        if (object->type == UACPI_OBJECT_OPERATION_REGION)
-            uacpi_opregion_uninstall_handler(node);
-
-        uacpi_object_unref(node->object);
-        node->object = UACPI_NULL;
-    }
+    if (uacpi_unlikely_error(namespace_write_begin()))
+        return;
 
     prev = node->parent ? node->parent->child : UACPI_NULL;
 
+    /*
+     * Only the link pointing at this node is changed, node->next is left
+     * intact so that readers currently standing on it can still move on.
+     */
     if (prev == node) {
-        node->parent->child = node->next;
+        uacpi_atomic_store_ptr(&node->parent->child, node->next);
     } else {
         while (uacpi_likely(prev != UACPI_NULL) && prev->next != node)
             prev = prev->next;
 
         if (uacpi_unlikely(prev == UACPI_NULL)) {
+            namespace_write_end();
             uacpi_warn(
                 "trying to uninstall a node %.4s (%p) not linked to any peer\n",
                 node->name.text, node
@@ -386,33 +890,83 @@ void uacpi_node_uninstall(uacpi_namespace_node *node)
             return;
         }
 
-        prev->next = node->next;
+        uacpi_atomic_store_ptr(&prev->next, node->next);
+    }
+
+    node->parent->child_count--;
+    child_index_remove(node->parent, node);
+
+    namespace_write_end();
+    maybe_reclaim_retired();
+
+    object = uacpi_namespace_node_get_object(node);
+    if (object != UACPI_NULL) {
+        if (object->type == UACPI_OBJECT_OPERATION_REGION)
+            uacpi_opregion_uninstall_handler(node);
+
+        uacpi_object_unref(node->object);
+        node->object = UACPI_NULL;
     }
 
     node->flags |= UACPI_NAMESPACE_NODE_FLAG_DANGLING;
     uacpi_namespace_node_unref(node);
 }
 
-uacpi_namespace_node *uacpi_namespace_node_find_sub_node(
-    uacpi_namespace_node *parent,
-    uacpi_object_name name
+static uacpi_namespace_node *do_find_sub_node(
+    uacpi_namespace_node *parent, uacpi_object_name name
 )
 {
-    if (parent == UACPI_NULL)
-        parent = uacpi_namespace_root();
+    uacpi_namespace_node *node;
+    struct uacpi_namespace_child_index *index;
+
+    index = uacpi_atomic_load_ptr(&parent->child_index);
+    if (index != UACPI_NULL) {
+        uacpi_u32 mask = child_index_capacity(index) - 1;
+        uacpi_u32 slot = child_index_hash(index, name);
 
-    uacpi_namespace_node *node = parent->child;
+        while ((node = uacpi_atomic_load_ptr(&index->slots[slot]))) {
+            if (node->name.id == name.id)
+                return node;
 
+            slot = (slot + 1) & mask;
+        }
+
+        return UACPI_NULL;
+    }
+
+    node = uacpi_atomic_load_ptr(&parent->child);
     while (node) {
         if (node->name.id == name.id)
             return node;
 
-        node = node->next;
+        node = uacpi_atomic_load_ptr(&node->next);
     }
 
     return UACPI_NULL;
 }
 
+uacpi_namespace_node *uacpi_namespace_node_find_sub_node(
+    uacpi_namespace_node *parent,
+    uacpi_object_name name
+)
+{
+    uacpi_namespace_node *node;
+    uacpi_u32 token, seq;
+
+    if (parent == UACPI_NULL)
+        parent = uacpi_namespace_root();
+
+    token = uacpi_namespace_read_lock();
+
+    do {
+        seq = namespace_read_begin();
+        node = do_find_sub_node(parent, name);
+    } while (uacpi_unlikely(namespace_read_retry(seq)));
+
+    uacpi_namespace_read_unlock(token);
+    return node;
+}
+
 static uacpi_object_name segment_to_name(
     const uacpi_char **string, uacpi_size *in_out_size
 )
@@ -441,7 +995,7 @@ enum may_search_above_parent {
     MAY_SEARCH_ABOVE_PARENT_YES,
 };
 
-static uacpi_namespace_node *uacpi_namespace_node_do_find(
+static uacpi_namespace_node *do_find_path(
     uacpi_namespace_node *parent, const uacpi_char *path,
     enum may_search_above_parent may_search_above_parent
 )
@@ -538,6 +1092,31 @@ out_invalid_path:
     return UACPI_NULL;
 }
 
+static uacpi_namespace_node *uacpi_namespace_node_do_find(
+    uacpi_namespace_node *parent, const uacpi_char *path,
+    enum may_search_above_parent may_search_above_parent
+)
+{
+    uacpi_namespace_node *node;
+    uacpi_u32 token;
+
+    // Keep every intermediate scope alive while we walk through it
+    token = uacpi_namespace_read_lock();
+    node = do_find_path(parent, path, may_search_above_parent);
+
+    /*
+     * The node might be freed as soon as we leave the read-side section,
+     * so hand out a reference. A node whose count has already dropped to
+     * zero is being uninstalled and is as good as not found.
+     */
+    if (node != UACPI_NULL && !uacpi_shareable_try_ref(node))
+        node = UACPI_NULL;
+
+    uacpi_namespace_read_unlock(token);
+
+    return node;
+}
+
 uacpi_namespace_node *uacpi_namespace_node_find(
     uacpi_namespace_node *parent, const uacpi_char *path
 )
@@ -575,18 +1154,29 @@ void uacpi_namespace_for_each_node_depth_first(
     void *user
 )
 {
+    uacpi_namespace_node *next;
     uacpi_bool walking_up = UACPI_FALSE;
-    uacpi_u32 depth = 1;
+    uacpi_u32 depth = 1, token;
 
-    if (node == UACPI_NULL || node->child == UACPI_NULL)
+    if (node == UACPI_NULL)
         return;
 
-    node = node->child;
+    /*
+     * The whole walk is a single read-side critical section, which means
+     * nodes uninstalled by the callback (e.g. method-local named objects) are
+     * only reclaimed once it's over.
+     */
+    token = uacpi_namespace_read_lock();
+
+    node = uacpi_atomic_load_ptr(&node->child);
+    if (node == UACPI_NULL)
+        goto out;
 
     while (depth) {
         if (walking_up) {
-            if (node->next) {
-                node = node->next;
+            next = uacpi_atomic_load_ptr(&node->next);
+            if (next) {
+                node = next;
                 walking_up = UACPI_FALSE;
                 continue;
             }
@@ -598,8 +1188,9 @@ void uacpi_namespace_for_each_node_depth_first(
 
         switch (callback(user, node)) {
         case UACPI_NS_ITERATION_DECISION_CONTINUE:
-            if (node->child) {
-                node = node->child;
+            next = uacpi_atomic_load_ptr(&node->child);
+            if (next) {
+                node = next;
                 depth++;
                 continue;
             }
@@ -610,9 +1201,12 @@ void uacpi_namespace_for_each_node_depth_first(
 
         case UACPI_NS_ITERATION_DECISION_BREAK:
         default:
-            return;
+            goto out;
         }
     }
+
+out:
+    uacpi_namespace_read_unlock(token);
 }
 
 uacpi_size uacpi_namespace_node_depth(const uacpi_namespace_node *node)
@@ -57,43 +57,208 @@ uacpi_handlers *uacpi_node_get_handlers(
     }
 }
 
+#ifndef UACPI_NOTIFY_MAX_WORKERS
+    /*
+     * Maximum number of notification work items in flight at the same time.
+     * Each of them keeps delivering pending notifications until there are
+     * none left, so this also caps how many CPUs notifications can occupy.
+     */
+    #define UACPI_NOTIFY_MAX_WORKERS 4
+#endif
+
+#define NOTIFY_LANE_COUNT UACPI_NOTIFY_PRIORITY_LOW
+
 struct notification_ctx {
+    struct notification_ctx *next;
     uacpi_namespace_node *node;
     uacpi_u64 value;
-    uacpi_device_notify_handler *node_handlers, *root_handlers;
 };
 
-static void do_notify(uacpi_handle opaque)
+struct notification_lane {
+    struct notification_ctx *head, *tail;
+};
+
+struct notify_priority_override {
+    struct notify_priority_override *next;
+    uacpi_namespace_node *node;
+    uacpi_notify_priority priority;
+};
+
+/*
+ * Notifications waiting for delivery, one FIFO per priority. A notification
+ * that is identical to one still waiting in its lane is dropped, so a burst
+ * of the same Notify() is only delivered once.
+ */
+struct notification_queue {
+    uacpi_handle lock;
+    struct notification_lane lanes[NOTIFY_LANE_COUNT];
+    struct notify_priority_override *overrides;
+    uacpi_u32 num_workers;
+    uacpi_notify_stats stats;
+};
+
+static struct notification_queue g_notify_queue;
+
+uacpi_status uacpi_initialize_notify(void)
 {
-    struct notification_ctx *ctx = opaque;
-    uacpi_device_notify_handler *handler;
-    uacpi_bool did_notify_root = UACPI_FALSE;
+    if (g_notify_queue.lock != UACPI_NULL)
+        return UACPI_STATUS_OK;
 
-    handler = ctx->node_handlers;
+    g_notify_queue.lock = uacpi_kernel_create_spinlock();
+    if (uacpi_unlikely(g_notify_queue.lock == UACPI_NULL))
+        return UACPI_STATUS_OUT_OF_MEMORY;
 
-    for (;;) {
-        if (handler == UACPI_NULL) {
-            if (did_notify_root) {
-                uacpi_namespace_node_unref(ctx->node);
-                uacpi_free(ctx, sizeof(*ctx));
-                return;
-            }
-
-            handler = ctx->root_handlers;
-            did_notify_root = UACPI_TRUE;
-            continue;
+    return UACPI_STATUS_OK;
+}
+
+void uacpi_deinitialize_notify(void)
+{
+    uacpi_size i;
+    struct notification_ctx *ctx, *next_ctx;
+    struct notify_priority_override *override, *next_override;
+    uacpi_handle lock = g_notify_queue.lock;
+
+    if (lock == UACPI_NULL)
+        return;
+
+    for (i = 0; i < NOTIFY_LANE_COUNT; ++i) {
+        ctx = g_notify_queue.lanes[i].head;
+
+        while (ctx != UACPI_NULL) {
+            next_ctx = ctx->next;
+            uacpi_namespace_node_unref(ctx->node);
+            uacpi_free(ctx, sizeof(*ctx));
+            ctx = next_ctx;
         }
+    }
+
+    override = g_notify_queue.overrides;
+    while (override != UACPI_NULL) {
+        next_override = override->next;
+        uacpi_namespace_node_unref(override->node);
+        uacpi_free(override, sizeof(*override));
+        override = next_override;
+    }
+
+    uacpi_memzero(&g_notify_queue, sizeof(g_notify_queue));
+    uacpi_kernel_free_spinlock(lock);
+}
+
+static uacpi_notify_priority notify_priority_of(uacpi_namespace_node *node)
+{
+    struct notify_priority_override *override;
+    uacpi_object *obj;
+
+    for (override = g_notify_queue.overrides; override != UACPI_NULL;
+         override = override->next) {
+        if (override->node == node)
+            return override->priority;
+    }
+
+    obj = uacpi_namespace_node_get_object(node);
+    if (obj != UACPI_NULL && (obj->type == UACPI_OBJECT_THERMAL_ZONE ||
+                              obj->type == UACPI_OBJECT_PROCESSOR))
+        return UACPI_NOTIFY_PRIORITY_HIGH;
+
+    return UACPI_NOTIFY_PRIORITY_NORMAL;
+}
+
+static struct notification_ctx *notification_dequeue(void)
+{
+    uacpi_size i;
+    struct notification_lane *lane;
+    struct notification_ctx *ctx;
+
+    for (i = 0; i < NOTIFY_LANE_COUNT; ++i) {
+        lane = &g_notify_queue.lanes[i];
+
+        ctx = lane->head;
+        if (ctx == UACPI_NULL)
+            continue;
+
+        lane->head = ctx->next;
+        if (lane->head == UACPI_NULL)
+            lane->tail = UACPI_NULL;
+
+        return ctx;
+    }
+
+    return UACPI_NULL;
+}
+
+static uacpi_bool notification_unlink(
+    struct notification_lane *lane, struct notification_ctx *ctx
+)
+{
+    struct notification_ctx *prev = UACPI_NULL, *cur;
+
+    for (cur = lane->head; cur != ctx; cur = cur->next) {
+        if (cur == UACPI_NULL)
+            return UACPI_FALSE;
+
+        prev = cur;
+    }
+
+    if (prev == UACPI_NULL)
+        lane->head = ctx->next;
+    else
+        prev->next = ctx->next;
+
+    if (lane->tail == ctx)
+        lane->tail = prev;
+
+    return UACPI_TRUE;
+}
+
+static void deliver_notification(struct notification_ctx *ctx)
+{
+    uacpi_handlers *handlers;
+    uacpi_device_notify_handler *handler;
 
+    handlers = uacpi_node_get_handlers(ctx->node);
+    if (handlers != UACPI_NULL) {
+        for (handler = handlers->notify_head; handler != UACPI_NULL;
+             handler = handler->next)
+            handler->callback(handler->user_context, ctx->node, ctx->value);
+    }
+
+    handlers = uacpi_node_get_handlers(uacpi_namespace_root());
+    for (handler = handlers->notify_head; handler != UACPI_NULL;
+         handler = handler->next)
         handler->callback(handler->user_context, ctx->node, ctx->value);
-        handler = handler->next;
+}
+
+static void do_notify(uacpi_handle opaque)
+{
+    struct notification_ctx *ctx;
+    uacpi_cpu_flags flags;
+
+    UACPI_UNUSED(opaque);
+
+    for (;;) {
+        flags = uacpi_kernel_lock_spinlock(g_notify_queue.lock);
+        ctx = notification_dequeue();
+        if (ctx == UACPI_NULL)
+            g_notify_queue.num_workers--;
+        uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+
+        if (ctx == UACPI_NULL)
+            return;
+
+        deliver_notification(ctx);
+        uacpi_namespace_node_unref(ctx->node);
+        uacpi_free(ctx, sizeof(*ctx));
     }
 }
 
 uacpi_status uacpi_notify_all(uacpi_namespace_node *node, uacpi_u64 value)
 {
     uacpi_status ret;
-    struct notification_ctx *ctx;
+    struct notification_ctx *ctx, *pending;
+    struct notification_lane *lane;
     uacpi_handlers *node_handlers, *root_handlers;
+    uacpi_cpu_flags flags;
+    uacpi_bool need_worker;
 
     node_handlers = uacpi_node_get_handlers(node);
     if (uacpi_unlikely(node_handlers == UACPI_NULL))
@@ -109,24 +274,72 @@ uacpi_status uacpi_notify_all(uacpi_namespace_node *node, uacpi_u64 value)
     if (uacpi_unlikely(ctx == UACPI_NULL))
         return UACPI_STATUS_OUT_OF_MEMORY;
 
+    ctx->next = UACPI_NULL;
     ctx->node = node;
+    ctx->value = value;
+
+    flags = uacpi_kernel_lock_spinlock(g_notify_queue.lock);
+
+    lane = &g_notify_queue.lanes[notify_priority_of(node) - 1];
+
+    for (pending = lane->head; pending != UACPI_NULL; pending = pending->next) {
+        if (pending->node == node && pending->value == value)
+            break;
+    }
+
+    if (pending != UACPI_NULL) {
+        g_notify_queue.stats.coalesced++;
+        uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+        uacpi_free(ctx, sizeof(*ctx));
+        return UACPI_STATUS_OK;
+    }
+
     // In case this node goes out of scope
     uacpi_shareable_ref(node);
 
-    ctx->value = value;
-    ctx->node_handlers = node_handlers->notify_head;
-    ctx->root_handlers = root_handlers->notify_head;
-
-    ret = uacpi_kernel_schedule_work(UACPI_WORK_NOTIFICATION, do_notify, ctx);
-    if (uacpi_unlikely_error(ret)) {
-        uacpi_warn("unable to schedule notification work: %s\n",
-                   uacpi_status_to_string(ret));
-        uacpi_namespace_node_unref(node);
-        uacpi_free(ctx, sizeof(*ctx));
-        return ret;
+    if (lane->tail != UACPI_NULL)
+        lane->tail->next = ctx;
+    else
+        lane->head = ctx;
+    lane->tail = ctx;
+    g_notify_queue.stats.queued++;
+
+    need_worker = g_notify_queue.num_workers < UACPI_NOTIFY_MAX_WORKERS;
+    if (need_worker)
+        g_notify_queue.num_workers++;
+
+    uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+
+    if (!need_worker)
+        return UACPI_STATUS_OK;
+
+    ret = uacpi_kernel_schedule_work(
+        UACPI_WORK_NOTIFICATION, do_notify, UACPI_NULL
+    );
+    if (uacpi_likely_success(ret))
+        return UACPI_STATUS_OK;
+
+    uacpi_warn("unable to schedule notification work: %s\n",
+               uacpi_status_to_string(ret));
+
+    flags = uacpi_kernel_lock_spinlock(g_notify_queue.lock);
+    g_notify_queue.num_workers--;
+
+    /*
+     * If another worker is still running it's going to deliver this as well,
+     * otherwise take the notification back out and let the caller know.
+     */
+    if (g_notify_queue.num_workers != 0 || !notification_unlink(lane, ctx)) {
+        uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+        return UACPI_STATUS_OK;
     }
 
-    return UACPI_STATUS_OK;
+    g_notify_queue.stats.queued--;
+    uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+
+    uacpi_namespace_node_unref(node);
+    uacpi_free(ctx, sizeof(*ctx));
+    return ret;
 }
 
 static uacpi_device_notify_handler *handler_container(
@@ -208,3 +421,78 @@ out:
     uacpi_free(containing, sizeof(*containing));
     return UACPI_STATUS_OK;
 }
+
+uacpi_status uacpi_set_notify_priority(
+    uacpi_namespace_node *node, uacpi_notify_priority priority
+)
+{
+    uacpi_cpu_flags flags;
+    struct notify_priority_override *override, *prev = UACPI_NULL;
+    struct notify_priority_override *new_override = UACPI_NULL;
+
+    if (uacpi_unlikely(priority > UACPI_NOTIFY_PRIORITY_LOW))
+        return UACPI_STATUS_INVALID_ARGUMENT;
+    if (uacpi_unlikely(uacpi_node_get_handlers(node) == UACPI_NULL))
+        return UACPI_STATUS_INVALID_ARGUMENT;
+
+    if (priority != UACPI_NOTIFY_PRIORITY_DEFAULT) {
+        new_override = uacpi_kernel_alloc(sizeof(*new_override));
+        if (uacpi_unlikely(new_override == UACPI_NULL))
+            return UACPI_STATUS_OUT_OF_MEMORY;
+    }
+
+    flags = uacpi_kernel_lock_spinlock(g_notify_queue.lock);
+
+    for (override = g_notify_queue.overrides; override != UACPI_NULL;
+         override = override->next) {
+        if (override->node == node)
+            break;
+
+        prev = override;
+    }
+
+    if (override != UACPI_NULL && new_override != UACPI_NULL) {
+        override->priority = priority;
+        uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+        uacpi_free(new_override, sizeof(*new_override));
+        return UACPI_STATUS_OK;
+    }
+
+    if (override != UACPI_NULL) {
+        if (prev == UACPI_NULL)
+            g_notify_queue.overrides = override->next;
+        else
+            prev->next = override->next;
+    }
+
+    if (new_override != UACPI_NULL) {
+        uacpi_shareable_ref(node);
+        new_override->node = node;
+        new_override->priority = priority;
+        new_override->next = g_notify_queue.overrides;
+        g_notify_queue.overrides = new_override;
+    }
+
+    uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+
+    if (override != UACPI_NULL) {
+        uacpi_namespace_node_unref(override->node);
+        uacpi_free(override, sizeof(*override));
+    }
+
+    return UACPI_STATUS_OK;
+}
+
+void uacpi_notify_get_stats(uacpi_notify_stats *out_stats)
+{
+    uacpi_cpu_flags flags;
+
+    if (g_notify_queue.lock == UACPI_NULL) {
+        *out_stats = g_notify_queue.stats;
+        return;
+    }
+
+    flags = uacpi_kernel_lock_spinlock(g_notify_queue.lock);
+    *out_stats = g_notify_queue.stats;
+    uacpi_kernel_unlock_spinlock(g_notify_queue.lock, flags);
+}
@@ -30,6 +30,7 @@
 #include <uacpi/internal/stdlib.h>
 #include <uacpi/internal/log.h>
 #include <uacpi/internal/utilities.h>
+#include <uacpi/internal/interpreter.h>
 
 void uacpi_trace_region_error(
     uacpi_namespace_node *node, uacpi_char *message, uacpi_status ret
@@ -203,13 +204,40 @@ static uacpi_operation_region *find_previous_region_link(
     return parent;
 }
 
+/*
+ * Host handler callbacks are made with the interpreter lock dropped, as they
+ * may block for a long time. The caller must hold a reference to the handler.
+ */
+static void region_detach(
+    uacpi_namespace_node *node, uacpi_address_space_handler *handler,
+    uacpi_handle region_context
+)
+{
+    uacpi_status ret;
+    uacpi_u32 depth;
+    uacpi_region_detach_data detach_data = {
+        .region_node = node,
+        .region_context = region_context,
+        .handler_context = handler->user_context,
+    };
+
+    depth = uacpi_interpreter_suspend();
+    ret = handler->callback(UACPI_REGION_OP_DETACH, &detach_data);
+    uacpi_interpreter_resume(depth);
+
+    if (uacpi_unlikely_error(ret))
+        uacpi_trace_region_error(node, "error during handler detach for", ret);
+}
+
 uacpi_status uacpi_opregion_attach(uacpi_namespace_node *node)
 {
     uacpi_operation_region *region;
     uacpi_address_space_handler *handler;
     uacpi_status ret;
-    uacpi_region_attach_data attach_data = { 0 };
+    uacpi_u32 depth;
+    uacpi_region_attach_data attach_data;
 
+retry:
     if (uacpi_namespace_node_is_dangling(node))
         return UACPI_STATUS_NAMESPACE_NODE_DANGLING;
 
@@ -220,17 +248,36 @@ uacpi_status uacpi_opregion_attach(uacpi_namespace_node *node)
         return UACPI_STATUS_OK;
 
     handler = region->handler;
+    uacpi_memzero(&attach_data, sizeof(attach_data));
     attach_data.region_node = node;
     attach_data.handler_context = handler->user_context;
 
+    uacpi_shareable_ref(handler);
+    depth = uacpi_interpreter_suspend();
     ret = handler->callback(UACPI_REGION_OP_ATTACH, &attach_data);
+    uacpi_interpreter_resume(depth);
+
     if (uacpi_unlikely_error(ret)) {
         uacpi_trace_region_error(node, "failed to attach a handler to", ret);
+        uacpi_address_space_handler_unref(handler);
         return ret;
     }
 
+    /*
+     * Other AML ran while we were out of the interpreter. If it attached the
+     * region first, or the handler was swapped out from under us, undo our
+     * attach and start over from whatever state the region is in now.
+     */
+    if (region->handler != handler ||
+        (region->state_flags & UACPI_OP_REGION_STATE_ATTACHED)) {
+        region_detach(node, handler, attach_data.out_region_context);
+        uacpi_address_space_handler_unref(handler);
+        goto retry;
+    }
+
     region->state_flags |= UACPI_OP_REGION_STATE_ATTACHED;
     region->user_context = attach_data.out_region_context;
+    uacpi_address_space_handler_unref(handler);
     return ret;
 }
 
@@ -251,6 +298,7 @@ void uacpi_opregion_uninstall_handler(uacpi_namespace_node *node)
 {
     uacpi_address_space_handler *handler;
     uacpi_operation_region *region, *link;
+    uacpi_u8 state_flags;
 
     region = uacpi_namespace_node_get_object(node)->op_region;
     handler = region->handler;
@@ -271,29 +319,23 @@ void uacpi_opregion_uninstall_handler(uacpi_namespace_node *node)
     }
 
 out:
-    if (region->state_flags & UACPI_OP_REGION_STATE_ATTACHED) {
-        uacpi_status ret;
-        uacpi_region_detach_data detach_data = {
-            .region_node = node,
-            .region_context = region->user_context,
-            .handler_context = handler->user_context,
-        };
-
-        ret = handler->callback(UACPI_REGION_OP_DETACH, &detach_data);
-        if (uacpi_unlikely_error(ret)) {
-            uacpi_trace_region_error(
-                node, "error during handler detach for", ret
-            );
-        }
-    }
-
-    if (region->state_flags & UACPI_OP_REGION_STATE_REG_EXECUTED)
-        region_run_reg(node, ACPI_REG_DISCONNECT);
-
-    uacpi_address_space_handler_unref(region->handler);
+    /*
+     * The region is disconnected before the handler is told, as other AML
+     * may run while the detach callback has the interpreter lock dropped.
+     * Our reference to the handler is the one the region held.
+     */
+    state_flags = region->state_flags;
     region->handler = UACPI_NULL;
     region->state_flags &= ~(UACPI_OP_REGION_STATE_ATTACHED |
                              UACPI_OP_REGION_STATE_REG_EXECUTED);
+
+    if (state_flags & UACPI_OP_REGION_STATE_ATTACHED)
+        region_detach(node, handler, region->user_context);
+
+    if (state_flags & UACPI_OP_REGION_STATE_REG_EXECUTED)
+        region_run_reg(node, ACPI_REG_DISCONNECT);
+
+    uacpi_address_space_handler_unref(handler);
 }
 
 enum opregion_iter_action {
@@ -24,49 +24,105 @@
  *
  * */
 #include <uacpi/internal/shareable.h>
+#include <uacpi/platform/atomic.h>
 
 #define BUGGED_REFCOUNT 0xFFFFFFFF
 
+/*
+ * All reference count transitions are done with a compare-exchange loop so
+ * that objects and namespace nodes can be shared between CPUs without an
+ * external lock. A count of zero is never valid for a live shareable, so
+ * observing one (or attempting to decrement past it) marks the shareable as
+ * bugged. BUGGED_REFCOUNT is sticky: once reached, either because of the above
+ * or because the count saturated, the shareable is leaked rather than freed.
+ */
+
 void uacpi_shareable_init(uacpi_handle handle)
 {
     struct uacpi_shareable *shareable = handle;
-    shareable->reference_count = 1;
+    uacpi_atomic_store32(&shareable->reference_count, 1);
 }
 
 uacpi_bool uacpi_bugged_shareable(uacpi_handle handle)
 {
     struct uacpi_shareable *shareable = handle;
-
-    if (uacpi_unlikely(shareable->reference_count == 0))
-        shareable->reference_count = BUGGED_REFCOUNT;
-
-    return shareable->reference_count == BUGGED_REFCOUNT;
+    uacpi_u32 value;
+
+    value = uacpi_atomic_load32(&shareable->reference_count);
+    if (uacpi_unlikely(value == 0)) {
+        // Whoever loses the race has already turned it into BUGGED_REFCOUNT
+        uacpi_atomic_cmpxchg32(
+            &shareable->reference_count, &value, BUGGED_REFCOUNT
+        );
+        return UACPI_TRUE;
+    }
+
+    return value == BUGGED_REFCOUNT;
 }
 
 void uacpi_make_shareable_bugged(uacpi_handle handle)
 {
     struct uacpi_shareable *shareable = handle;
-    shareable->reference_count = BUGGED_REFCOUNT;
+    uacpi_atomic_store32(&shareable->reference_count, BUGGED_REFCOUNT);
 }
 
-uacpi_u32 uacpi_shareable_ref(uacpi_handle handle)
+/*
+ * Applies 'delta' to the reference count and returns the value it had before,
+ * or BUGGED_REFCOUNT if the shareable is (or just became) bugged.
+ */
+static uacpi_u32 shareable_update(
+    struct uacpi_shareable *shareable, uacpi_i32 delta
+)
 {
-    struct uacpi_shareable *shareable = handle;
-
-    if (uacpi_unlikely(uacpi_bugged_shareable(shareable)))
-        return BUGGED_REFCOUNT;
+    uacpi_u32 value, new_value;
+
+    value = uacpi_atomic_load32(&shareable->reference_count);
+    do {
+        if (uacpi_unlikely(value == 0 || value == BUGGED_REFCOUNT)) {
+            uacpi_make_shareable_bugged(shareable);
+            return BUGGED_REFCOUNT;
+        }
+
+        /*
+         * Incrementing into BUGGED_REFCOUNT saturates the counter, which is
+         * exactly what we want for an overflowing reference count.
+         */
+        new_value = value + delta;
+    } while (!uacpi_atomic_cmpxchg32(
+        &shareable->reference_count, &value, new_value
+    ));
+
+    return value;
+}
 
-    return shareable->reference_count++;
+uacpi_u32 uacpi_shareable_ref(uacpi_handle handle)
+{
+    return shareable_update(handle, 1);
 }
 
 uacpi_u32 uacpi_shareable_unref(uacpi_handle handle)
+{
+    return shareable_update(handle, -1);
+}
+
+uacpi_bool uacpi_shareable_try_ref(uacpi_handle handle)
 {
     struct uacpi_shareable *shareable = handle;
+    uacpi_u32 value;
+
+    value = uacpi_atomic_load32(&shareable->reference_count);
+    do {
+        if (value == 0)
+            return UACPI_FALSE;
 
-    if (uacpi_unlikely(uacpi_bugged_shareable(shareable)))
-        return BUGGED_REFCOUNT;
+        // Bugged shareables are leaked, so they're always safe to use
+        if (uacpi_unlikely(value == BUGGED_REFCOUNT))
+            return UACPI_TRUE;
+    } while (!uacpi_atomic_cmpxchg32(
+        &shareable->reference_count, &value, value + 1
+    ));
 
-    return shareable->reference_count--;
+    return UACPI_TRUE;
 }
 
 void uacpi_shareable_unref_and_delete_if_last(
@@ -76,9 +132,11 @@ void uacpi_shareable_unref_and_delete_if_last(
     if (handle == UACPI_NULL)
         return;
 
-    if (uacpi_unlikely(uacpi_bugged_shareable(handle)))
-        return;
-
+    /*
+     * Only the thread that performs the 1 -> 0 transition may free the
+     * shareable, any other caller will see either a higher count or a
+     * bugged one.
+     */
     if (uacpi_shareable_unref(handle) == 1)
         do_free(handle);
 }
@@ -86,5 +144,5 @@ void uacpi_shareable_unref_and_delete_if_last(
 uacpi_u32 uacpi_shareable_refcount(uacpi_handle handle)
 {
     struct uacpi_shareable *shareable = handle;
-    return shareable->reference_count;
+    return uacpi_atomic_load32(&shareable->reference_count);
 }
@@ -25,6 +25,92 @@
  * */
 #include <uacpi/internal/stdlib.h>
 #include <uacpi/internal/utilities.h>
+#include <uacpi/internal/log.h>
+#include <uacpi/platform/atomic.h>
+
+/*
+ * On x86-64 the string helpers below move a machine word at a time and, when
+ * CPUID reports fast string operations (ERMS/FSRM), hand large buffers to
+ * rep movsb/stosb. None of this touches SSE registers, so it is fine for
+ * kernels built with -mno-sse. Other architectures use the plain byte loops.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define UACPI_X86_STRING_OPS
+
+typedef uacpi_size __attribute__((may_alias, aligned(1))) unaligned_word;
+
+#ifndef UACPI_REP_STRING_OP_THRESHOLD
+    /*
+     * Smallest buffer handed to rep movsb/stosb when only ERMS is available,
+     * below this the startup cost of the instruction outweighs the word loop.
+     * With FSRM short copies are fast as well and this is ignored for movsb.
+     */
+    #define UACPI_REP_STRING_OP_THRESHOLD 256
+#endif
+
+#define STRING_OP_CAPS_PROBED (1 << 0)
+#define STRING_OP_CAPS_ERMS (1 << 1)
+#define STRING_OP_CAPS_FSRM (1 << 2)
+
+static uacpi_u8 string_op_caps;
+
+static void string_op_cpuid(
+    uacpi_u32 leaf, uacpi_u32 *a, uacpi_u32 *b, uacpi_u32 *c, uacpi_u32 *d
+)
+{
+    __asm__ volatile(
+        "cpuid"
+        : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d)
+        : "a"(leaf), "c"(0)
+    );
+}
+
+/*
+ * Probed on first use rather than from uacpi_initialize(), the helpers are
+ * used by early table access way before that. Racing probes all store the
+ * same value.
+ */
+static uacpi_u8 get_string_op_caps(void)
+{
+    uacpi_u32 a, b, c, d;
+    uacpi_u8 caps = string_op_caps;
+
+    if (uacpi_likely(caps & STRING_OP_CAPS_PROBED))
+        return caps;
+
+    caps = STRING_OP_CAPS_PROBED;
+
+    string_op_cpuid(0, &a, &b, &c, &d);
+    if (a >= 7) {
+        string_op_cpuid(7, &a, &b, &c, &d);
+
+        if (b & (1 << 9))
+            caps |= STRING_OP_CAPS_ERMS;
+        if (d & (1 << 4))
+            caps |= STRING_OP_CAPS_FSRM;
+    }
+
+    string_op_caps = caps;
+    return caps;
+}
+
+static uacpi_bool use_rep_movsb(uacpi_size count)
+{
+    uacpi_u8 caps = get_string_op_caps();
+
+    if (caps & STRING_OP_CAPS_FSRM)
+        return count >= sizeof(uacpi_size);
+
+    return (caps & STRING_OP_CAPS_ERMS) &&
+           count >= UACPI_REP_STRING_OP_THRESHOLD;
+}
+
+static uacpi_bool use_rep_stosb(uacpi_size count)
+{
+    return (get_string_op_caps() & STRING_OP_CAPS_ERMS) &&
+           count >= UACPI_REP_STRING_OP_THRESHOLD;
+}
+#endif
 
 #ifndef uacpi_memcpy
 void *uacpi_memcpy(void *dest, const void *src, size_t count)
@@ -32,6 +118,24 @@ void *uacpi_memcpy(void *dest, const void *src, size_t count)
     uacpi_char *cd = dest;
     const uacpi_char *cs = src;
 
+#ifdef UACPI_X86_STRING_OPS
+    if (use_rep_movsb(count)) {
+        __asm__ volatile(
+            "rep movsb"
+            : "+D"(cd), "+S"(cs), "+c"(count)
+            :
+            : "memory"
+        );
+        return dest;
+    }
+
+    for (; count >= sizeof(uacpi_size); count -= sizeof(uacpi_size)) {
+        *(unaligned_word*)cd = *(const unaligned_word*)cs;
+        cd += sizeof(uacpi_size);
+        cs += sizeof(uacpi_size);
+    }
+#endif
+
     while (count--)
         *cd++ = *cs++;
 
@@ -49,11 +153,27 @@ void *uacpi_memmove(void *dest, const void *src, uacpi_size count)
         cs += count;
         cd += count;
 
+#ifdef UACPI_X86_STRING_OPS
+        for (; count >= sizeof(uacpi_size); count -= sizeof(uacpi_size)) {
+            cd -= sizeof(uacpi_size);
+            cs -= sizeof(uacpi_size);
+            *(unaligned_word*)cd = *(const unaligned_word*)cs;
+        }
+#endif
+
         while (count--)
             *--cd = *--cs;
     } else {
+#ifdef UACPI_X86_STRING_OPS
+        /*
+         * A forward copy, be it rep movsb or a word at a time, never
+         * overwrites source bytes it hasn't read yet when dest < src.
+         */
+        return uacpi_memcpy(dest, src, count);
+#else
         while (count--)
             *cd++ = *cs++;
+#endif
     }
 
     return dest;
@@ -66,6 +186,27 @@ void *uacpi_memset(void *dest, uacpi_i32 ch, uacpi_size count)
     uacpi_u8 fill = ch;
     uacpi_u8 *cdest = dest;
 
+#ifdef UACPI_X86_STRING_OPS
+    uacpi_size word_fill;
+
+    if (use_rep_stosb(count)) {
+        __asm__ volatile(
+            "rep stosb"
+            : "+D"(cdest), "+c"(count)
+            : "a"(fill)
+            : "memory"
+        );
+        return dest;
+    }
+
+    word_fill = (uacpi_size)0x0101010101010101ull * fill;
+
+    for (; count >= sizeof(uacpi_size); count -= sizeof(uacpi_size)) {
+        *(unaligned_word*)cdest = word_fill;
+        cdest += sizeof(uacpi_size);
+    }
+#endif
+
     while (count--)
         *cdest++ = fill;
 
@@ -78,9 +219,18 @@ uacpi_i32 uacpi_memcmp(const void *lhs, const void *rhs, uacpi_size count)
 {
     const uacpi_u8 *byte_lhs = lhs;
     const uacpi_u8 *byte_rhs = rhs;
-    uacpi_size i;
+    uacpi_size i = 0;
+
+#ifdef UACPI_X86_STRING_OPS
+    // Skip over equal words, the byte loop below finds the actual difference
+    for (; count - i >= sizeof(uacpi_size); i += sizeof(uacpi_size)) {
+        if (*(const unaligned_word*)&byte_lhs[i] !=
+            *(const unaligned_word*)&byte_rhs[i])
+            break;
+    }
+#endif
 
-    for (i = 0; i < count; ++i) {
+    for (; i < count; ++i) {
         if (byte_lhs[i] != byte_rhs[i])
             return byte_lhs[i] - byte_rhs[i];
     }
@@ -685,6 +835,55 @@ uacpi_u8 uacpi_popcount(uacpi_u64 value)
 #endif
 }
 
+#define UACPI_RL_USED(state) ((state) & 0xFFFF)
+#define UACPI_RL_SUPPRESSED(state) (((state) >> 16) & 0xFFFF)
+#define UACPI_RL_TIME(state) ((uacpi_u32)((state) >> 32))
+#define UACPI_RL_STATE(used, suppressed, time)          \
+    ((uacpi_u64)(used) | ((uacpi_u64)(suppressed) << 16) | \
+     ((uacpi_u64)(time) << 32))
+
+uacpi_bool uacpi_log_ratelimit_allow(
+    uacpi_log_ratelimit *rl, uacpi_log_level lvl
+)
+{
+    // Ticks are in units of 100ns
+    uacpi_u32 now = uacpi_kernel_get_ticks() / 10000;
+    uacpi_u64 state, next;
+    uacpi_u32 used, time, refill, suppressed;
+    uacpi_bool pass;
+
+    state = uacpi_atomic_load64(&rl->state);
+
+    do {
+        used = UACPI_RL_USED(state);
+        time = UACPI_RL_TIME(state);
+        refill = (now - time) / UACPI_LOG_RATELIMIT_PERIOD_MS;
+
+        if (refill >= used) {
+            used = 0;
+            time = now;
+        } else {
+            used -= refill;
+            time += refill * UACPI_LOG_RATELIMIT_PERIOD_MS;
+        }
+
+        suppressed = UACPI_RL_SUPPRESSED(state);
+        pass = used < UACPI_LOG_RATELIMIT_BURST;
+
+        if (pass)
+            next = UACPI_RL_STATE(used + 1, 0, time);
+        else if (suppressed < 0xFFFF)
+            next = UACPI_RL_STATE(used, suppressed + 1, time);
+        else
+            next = UACPI_RL_STATE(used, suppressed, time);
+    } while (!uacpi_atomic_cmpxchg64(&rl->state, &state, next));
+
+    if (pass && suppressed)
+        uacpi_log(lvl, "%u similar messages suppressed\n", suppressed);
+
+    return pass;
+}
+
 #ifndef UACPI_FORMATTED_LOGGING
 
 #ifndef UACPI_PLAIN_LOG_BUFFER_SIZE
@@ -56,6 +56,59 @@ static uacpi_bool early_table_access;
 static uacpi_table_installation_handler installation_handler;
 static uacpi_handle table_mutex;
 
+#ifndef UACPI_TABLE_SIGNATURE_SLOTS
+    // Must be a power of two
+    #define UACPI_TABLE_SIGNATURE_SLOTS 64
+#endif
+
+/*
+ * Installed tables with the same signature are linked together in install
+ * order via next_same_signature. The first and last table of every chain are
+ * kept in a small open-addressed hash keyed by the signature, so finding a
+ * table by signature only ever looks at tables that have that signature.
+ */
+struct table_signature_chain {
+    uacpi_object_name signature;
+    uacpi_u32 first_idx;
+    uacpi_u32 last_idx;
+    uacpi_bool used;
+};
+
+static struct table_signature_chain
+signature_chains[UACPI_TABLE_SIGNATURE_SLOTS];
+
+/*
+ * Set if a signature didn't fit into signature_chains, lookups go back to
+ * scanning every installed table from then on.
+ */
+static uacpi_bool signature_chains_overflowed;
+
+#ifndef UACPI_TABLE_MAPPING_CACHE_SIZE
+    /*
+     * Number of physical tables kept mapped after their last reference is
+     * dropped. Setting this to 0 unmaps them right away.
+     */
+    #define UACPI_TABLE_MAPPING_CACHE_SIZE 8
+#endif
+
+#if UACPI_TABLE_MAPPING_CACHE_SIZE != 0
+/*
+ * Indices of unreferenced tables that are still mapped, least recently used
+ * first. Finding a table and dropping it again is a common pattern, and
+ * without this every such round trip would map and unmap the table.
+ */
+static uacpi_u32 mapping_cache[UACPI_TABLE_MAPPING_CACHE_SIZE];
+static uacpi_size mapping_cache_count;
+#endif
+
+static uacpi_table_mapping_cache_stats mapping_cache_stats;
+
+// Tables whose checksum was verified during a previous boot
+static const uacpi_verified_table *verified_tables;
+static uacpi_size num_verified_tables;
+
+static void mapping_cache_flush(void);
+
 static uacpi_status table_install_physical_with_origin_unlocked(
     uacpi_phys_addr phys, enum uacpi_table_origin origin,
     const uacpi_char *expected_signature, uacpi_table *out_table
@@ -280,6 +333,8 @@ void uacpi_deinitialize_tables(void)
 {
     uacpi_size i;
 
+    mapping_cache_flush();
+
     for (i = 0; i < table_array_size(&tables); ++i) {
         struct uacpi_installed_table *tbl = table_array_at(&tables, i);
 
@@ -307,6 +362,10 @@ void uacpi_deinitialize_tables(void)
     if (table_mutex)
         uacpi_kernel_free_mutex(table_mutex);
 
+    uacpi_memzero(signature_chains, sizeof(signature_chains));
+    signature_chains_overflowed = UACPI_FALSE;
+    uacpi_memzero(&mapping_cache_stats, sizeof(mapping_cache_stats));
+
     installation_handler = UACPI_NULL;
     table_mutex = UACPI_NULL;
 }
@@ -336,13 +395,106 @@ out:
 
 static uacpi_status initialize_fadt(const void*);
 
+uacpi_status uacpi_set_verified_table_cache(
+    const uacpi_verified_table *records, uacpi_size count
+)
+{
+    // Same as the installation handler, this may be set before init
+    UACPI_MUTEX_ACQUIRE_IF_EXISTS(table_mutex);
+
+    verified_tables = records;
+    num_verified_tables = records != UACPI_NULL ? count : 0;
+
+    UACPI_MUTEX_RELEASE_IF_EXISTS(table_mutex);
+    return UACPI_STATUS_OK;
+}
+
+struct get_verified_ctx {
+    uacpi_verified_table *out;
+    uacpi_size capacity;
+    uacpi_size count;
+};
+
+static enum uacpi_table_iteration_decision get_one_verified(
+    void *user, struct uacpi_installed_table *tbl, uacpi_size idx
+)
+{
+    struct get_verified_ctx *ctx = user;
+    uacpi_verified_table *vt;
+
+    UACPI_UNUSED(idx);
+
+    if (tbl->origin != UACPI_TABLE_ORIGIN_FIRMWARE_PHYSICAL ||
+        !(tbl->flags & UACPI_TABLE_CSUM_VERIFIED))
+        return UACPI_TABLE_ITERATION_DECISION_CONTINUE;
+
+    if (ctx->count < ctx->capacity) {
+        vt = &ctx->out[ctx->count];
+        vt->phys_addr = tbl->phys_addr;
+        vt->length = tbl->hdr.length;
+        vt->oem_revision = tbl->hdr.oem_revision;
+        vt->checksum = tbl->hdr.checksum;
+    }
+
+    ctx->count++;
+    return UACPI_TABLE_ITERATION_DECISION_CONTINUE;
+}
+
+uacpi_status uacpi_table_get_verified(
+    uacpi_verified_table *out_records, uacpi_size capacity,
+    uacpi_size *out_count
+)
+{
+    uacpi_status ret;
+    struct get_verified_ctx ctx = {
+        .out = out_records,
+        .capacity = out_records != UACPI_NULL ? capacity : 0,
+    };
+
+    ret = uacpi_for_each_table(0, get_one_verified, &ctx);
+    if (uacpi_unlikely_error(ret))
+        return ret;
+
+    *out_count = ctx.count;
+    return UACPI_STATUS_OK;
+}
+
 static uacpi_u8 table_checksum(void *table, uacpi_size size)
 {
     uacpi_u8 *bytes = table;
     uacpi_u8 csum = 0;
-    uacpi_size i;
+    uacpi_size i = 0;
+
+#ifdef __GNUC__
+    typedef uacpi_u64 __attribute__((may_alias)) aliasing_u64;
 
-    for (i = 0; i < size; ++i)
+    while (i < size && ((uacpi_uintptr)&bytes[i] & (sizeof(uacpi_u64) - 1)))
+        csum += bytes[i++];
+
+    /*
+     * Sum 8 bytes at a time. Even and odd bytes of every word are added into
+     * four 16-bit lanes, which can take 128 words before they might overflow,
+     * so they're folded into csum after at most that many.
+     */
+    while (size - i >= sizeof(uacpi_u64)) {
+        uacpi_u64 lanes = 0;
+        uacpi_size words = UACPI_MIN((size - i) / sizeof(uacpi_u64), 128);
+
+        for (; words != 0; words--, i += sizeof(uacpi_u64)) {
+            uacpi_u64 word = *(const aliasing_u64*)&bytes[i];
+
+            lanes += word & 0x00FF00FF00FF00FFull;
+            lanes += (word >> 8) & 0x00FF00FF00FF00FFull;
+        }
+
+        csum += (uacpi_u8)(
+            (lanes & 0xFFFF) + ((lanes >> 16) & 0xFFFF) +
+            ((lanes >> 32) & 0xFFFF) + (lanes >> 48)
+        );
+    }
+#endif
+
+    for (; i < size; ++i)
         csum += bytes[i];
 
     return csum;
@@ -401,6 +553,107 @@ uacpi_status uacpi_check_table_signature(void *table, const uacpi_char *expect)
     return ret;
 }
 
+static struct table_signature_chain *signature_chain_get(
+    const void *signature, uacpi_bool create
+)
+{
+    uacpi_object_name name;
+    uacpi_size i, slot;
+
+    uacpi_memcpy(&name, signature, sizeof(name));
+    slot = (uacpi_u32)(name.id * 0x9E3779B1u) >> 16;
+
+    for (i = 0; i < UACPI_TABLE_SIGNATURE_SLOTS; ++i) {
+        struct table_signature_chain *chain;
+
+        chain = &signature_chains[
+            (slot + i) & (UACPI_TABLE_SIGNATURE_SLOTS - 1)
+        ];
+
+        if (!chain->used) {
+            if (!create)
+                return UACPI_NULL;
+
+            chain->signature = name;
+            chain->first_idx = UACPI_TABLE_INDEX_NONE;
+            chain->last_idx = UACPI_TABLE_INDEX_NONE;
+            chain->used = UACPI_TRUE;
+            return chain;
+        }
+
+        if (chain->signature.id == name.id)
+            return chain;
+    }
+
+    return UACPI_NULL;
+}
+
+static void signature_chain_append(
+    struct uacpi_installed_table *tbl, uacpi_size idx
+)
+{
+    struct table_signature_chain *chain;
+
+    tbl->next_same_signature = UACPI_TABLE_INDEX_NONE;
+
+    chain = signature_chain_get(tbl->hdr.signature, UACPI_TRUE);
+    if (uacpi_unlikely(chain == UACPI_NULL)) {
+        if (!signature_chains_overflowed) {
+            uacpi_warn(
+                "more than %d distinct table signatures, falling back to "
+                "linear table lookups\n", UACPI_TABLE_SIGNATURE_SLOTS
+            );
+        }
+
+        signature_chains_overflowed = UACPI_TRUE;
+        return;
+    }
+
+    if (chain->first_idx == UACPI_TABLE_INDEX_NONE)
+        chain->first_idx = idx;
+    else
+        table_array_at(&tables, chain->last_idx)->next_same_signature = idx;
+
+    chain->last_idx = idx;
+}
+
+/*
+ * Index of the first table with this signature at or after base_idx. Chains
+ * are in install order, so if the table right before base_idx has the same
+ * signature (as is the case when looking for the next table with the same
+ * signature) this is just a link away.
+ */
+static uacpi_u32 signature_chain_start(
+    const void *signature, uacpi_size base_idx
+)
+{
+    struct table_signature_chain *chain;
+    struct uacpi_installed_table *tbl;
+    uacpi_u32 idx;
+
+    if (base_idx != 0) {
+        tbl = table_array_at(&tables, base_idx - 1);
+
+        if (tbl != UACPI_NULL &&
+            uacpi_signatures_match(tbl->hdr.signature, signature))
+            return tbl->next_same_signature;
+    }
+
+    chain = signature_chain_get(signature, UACPI_FALSE);
+    if (chain == UACPI_NULL)
+        return UACPI_TABLE_INDEX_NONE;
+
+    for (idx = chain->first_idx; idx != UACPI_TABLE_INDEX_NONE;
+         idx = tbl->next_same_signature) {
+        if (idx >= base_idx)
+            break;
+
+        tbl = table_array_at(&tables, idx);
+    }
+
+    return idx;
+}
+
 static uacpi_status table_alloc(
     struct uacpi_installed_table **out_tbl, uacpi_size *out_idx
 )
@@ -438,7 +691,85 @@ static uacpi_status get_external_table_header(
     return UACPI_STATUS_OK;
 }
 
-static uacpi_status table_ref_unlocked(struct uacpi_installed_table *tbl)
+static void mapping_cache_evict_one(void)
+{
+#if UACPI_TABLE_MAPPING_CACHE_SIZE != 0
+    struct uacpi_installed_table *tbl;
+
+    tbl = table_array_at(&tables, mapping_cache[0]);
+    uacpi_kernel_unmap(tbl->ptr, tbl->hdr.length);
+    tbl->ptr = UACPI_NULL;
+
+    mapping_cache_count--;
+    uacpi_memmove(
+        &mapping_cache[0], &mapping_cache[1],
+        mapping_cache_count * sizeof(mapping_cache[0])
+    );
+    mapping_cache_stats.evictions++;
+#endif
+}
+
+static void mapping_cache_flush(void)
+{
+#if UACPI_TABLE_MAPPING_CACHE_SIZE != 0
+    while (mapping_cache_count != 0)
+        mapping_cache_evict_one();
+#endif
+}
+
+/*
+ * Take the mapping of a table that is about to get its first reference back
+ * out of the cache. Returns UACPI_FALSE if it has to be mapped again.
+ */
+static uacpi_bool mapping_cache_take(uacpi_size idx)
+{
+#if UACPI_TABLE_MAPPING_CACHE_SIZE != 0
+    uacpi_size i;
+
+    for (i = 0; i < mapping_cache_count; ++i) {
+        if (mapping_cache[i] != idx)
+            continue;
+
+        mapping_cache_count--;
+        uacpi_memmove(
+            &mapping_cache[i], &mapping_cache[i + 1],
+            (mapping_cache_count - i) * sizeof(mapping_cache[0])
+        );
+        mapping_cache_stats.hits++;
+        return UACPI_TRUE;
+    }
+#else
+    UACPI_UNUSED(idx);
+#endif
+
+    mapping_cache_stats.misses++;
+    return UACPI_FALSE;
+}
+
+/*
+ * Keep the mapping of a table that just lost its last reference, unmapping
+ * the least recently used table in the cache if there's no room for it.
+ */
+static void mapping_cache_put(struct uacpi_installed_table *tbl, uacpi_size idx)
+{
+#if UACPI_TABLE_MAPPING_CACHE_SIZE != 0
+    UACPI_UNUSED(tbl);
+
+    if (mapping_cache_count == UACPI_TABLE_MAPPING_CACHE_SIZE)
+        mapping_cache_evict_one();
+
+    mapping_cache[mapping_cache_count++] = idx;
+#else
+    UACPI_UNUSED(idx);
+
+    uacpi_kernel_unmap(tbl->ptr, tbl->hdr.length);
+    tbl->ptr = UACPI_NULL;
+#endif
+}
+
+static uacpi_status table_ref_unlocked(
+    struct uacpi_installed_table *tbl, uacpi_size idx
+)
 {
     switch (tbl->reference_count) {
     case 0: {
@@ -451,6 +782,9 @@ static uacpi_status table_ref_unlocked(struct uacpi_installed_table *tbl)
             tbl->origin != UACPI_TABLE_ORIGIN_FIRMWARE_PHYSICAL)
             break;
 
+        if (mapping_cache_take(idx))
+            break;
+
         tbl->ptr = uacpi_kernel_map(tbl->phys_addr, tbl->hdr.length);
         if (uacpi_unlikely(tbl->ptr == UACPI_NULL))
             return UACPI_STATUS_MAPPING_FAILED;
@@ -483,7 +817,9 @@ static uacpi_status table_ref_unlocked(struct uacpi_installed_table *tbl)
     return UACPI_STATUS_OK;
 }
 
-static uacpi_status table_unref_unlocked(struct uacpi_installed_table *tbl)
+static uacpi_status table_unref_unlocked(
+    struct uacpi_installed_table *tbl, uacpi_size idx
+)
 {
     switch (tbl->reference_count) {
     case 0:
@@ -497,8 +833,7 @@ static uacpi_status table_unref_unlocked(struct uacpi_installed_table *tbl)
             tbl->origin != UACPI_TABLE_ORIGIN_FIRMWARE_PHYSICAL)
             break;
 
-        uacpi_kernel_unmap(tbl->ptr, tbl->hdr.length);
-        tbl->ptr = UACPI_NULL;
+        mapping_cache_put(tbl, idx);
         break;
     case 0xFFFF:
         /*
@@ -514,6 +849,28 @@ static uacpi_status table_unref_unlocked(struct uacpi_installed_table *tbl)
     return UACPI_STATUS_OK;
 }
 
+static uacpi_bool table_verified_previously(
+    enum uacpi_table_origin origin, uacpi_phys_addr phys_addr,
+    const struct acpi_sdt_hdr *hdr
+)
+{
+    uacpi_size i;
+
+    if (origin != UACPI_TABLE_ORIGIN_FIRMWARE_PHYSICAL)
+        return UACPI_FALSE;
+
+    for (i = 0; i < num_verified_tables; ++i) {
+        const uacpi_verified_table *vt = &verified_tables[i];
+
+        if (vt->phys_addr == phys_addr && vt->length == hdr->length &&
+            vt->oem_revision == hdr->oem_revision &&
+            vt->checksum == hdr->checksum)
+            return UACPI_TRUE;
+    }
+
+    return UACPI_FALSE;
+}
+
 static uacpi_status verify_and_install_table(
     struct acpi_sdt_hdr *hdr, uacpi_phys_addr phys_addr, void *virt_addr,
     enum uacpi_table_origin origin, uacpi_table *out_table
@@ -529,12 +886,16 @@ static uacpi_status verify_and_install_table(
 
     /*
      * FACS is the only(?) table without a checksum because it has OSPM
-     * writable fields. Don't try to validate it here.
+     * writable fields. Don't try to validate it here. Neither is there any
+     * point in validating a table that was already verified last boot.
      */
-    if (uacpi_signatures_match(hdr->signature, ACPI_FACS_SIGNATURE)) {
+    if (uacpi_signatures_match(hdr->signature, ACPI_FACS_SIGNATURE) ||
+        table_verified_previously(origin, phys_addr, hdr))
         flags |= UACPI_TABLE_CSUM_VERIFIED;
-    } else if (uacpi_check_flag(UACPI_FLAG_PROACTIVE_TBL_CSUM) || is_fadt ||
-               out_table != UACPI_NULL) {
+
+    if (is_fadt || (!(flags & UACPI_TABLE_CSUM_VERIFIED) &&
+                    (uacpi_check_flag(UACPI_FLAG_PROACTIVE_TBL_CSUM) ||
+                     out_table != UACPI_NULL))) {
         void *mapping = virt_addr;
 
         // We may already have a valid mapping, reuse it if we do
@@ -543,13 +904,16 @@ static uacpi_status verify_and_install_table(
         if (uacpi_unlikely(mapping == UACPI_NULL))
             return UACPI_STATUS_MAPPING_FAILED;
 
-        ret = uacpi_verify_table_checksum(mapping, hdr->length);
-        if (uacpi_likely_success(ret)) {
-            if (is_fadt)
-                ret = initialize_fadt(mapping);
-            flags |= UACPI_TABLE_CSUM_VERIFIED;
+        ret = UACPI_STATUS_OK;
+        if (!(flags & UACPI_TABLE_CSUM_VERIFIED)) {
+            ret = uacpi_verify_table_checksum(mapping, hdr->length);
+            if (uacpi_likely_success(ret))
+                flags |= UACPI_TABLE_CSUM_VERIFIED;
         }
 
+        if (uacpi_likely_success(ret) && is_fadt)
+            ret = initialize_fadt(mapping);
+
         if (virt_addr == UACPI_NULL)
             uacpi_kernel_unmap(mapping, hdr->length);
 
@@ -569,6 +933,7 @@ static uacpi_status verify_and_install_table(
     table->ptr = virt_addr;
     table->flags = flags;
     table->origin = origin;
+    signature_chain_append(table, idx);
 
     if (out_table == UACPI_NULL)
         return UACPI_STATUS_OK;
@@ -861,7 +1226,7 @@ static enum uacpi_table_iteration_decision do_search_tables(
         return UACPI_TABLE_ITERATION_DECISION_BREAK;
     }
 
-    ret = table_ref_unlocked(tbl);
+    ret = table_ref_unlocked(tbl, idx);
     if (uacpi_likely_success(ret)) {
         out_table = ctx->out_table;
         out_table->ptr = tbl->ptr;
@@ -912,11 +1277,35 @@ static uacpi_status find_table(
         .search_type = SEARCH_TYPE_BY_ID,
         .status = UACPI_STATUS_NOT_FOUND,
     };
+    struct uacpi_installed_table *tbl;
+    uacpi_u32 idx;
 
-    ret = uacpi_for_each_table(base_idx, do_search_tables, &ctx);
-    if (uacpi_unlikely_error(ret))
-        return ret;
+    UACPI_MUTEX_ACQUIRE_IF_EXISTS(table_mutex);
+
+    if (uacpi_unlikely(signature_chains_overflowed)) {
+        UACPI_MUTEX_RELEASE_IF_EXISTS(table_mutex);
+
+        ret = uacpi_for_each_table(base_idx, do_search_tables, &ctx);
+        if (uacpi_unlikely_error(ret))
+            return ret;
+
+        return ctx.status;
+    }
+
+    idx = signature_chain_start(&id->signature, base_idx);
+
+    for (; idx != UACPI_TABLE_INDEX_NONE; idx = tbl->next_same_signature) {
+        tbl = table_array_at(&tables, idx);
+
+        if (tbl->flags & UACPI_TABLE_INVALID)
+            continue;
+
+        if (do_search_tables(&ctx, tbl, idx) ==
+            UACPI_TABLE_ITERATION_DECISION_BREAK)
+            break;
+    }
 
+    UACPI_MUTEX_RELEASE_IF_EXISTS(table_mutex);
     return ctx.status;
 }
 
@@ -1035,7 +1424,7 @@ static uacpi_status table_ctl(uacpi_size idx, struct table_ctl_request *req)
     }
 
     if (req->type & TABLE_CTL_GET) {
-        ret = table_ref_unlocked(tbl);
+        ret = table_ref_unlocked(tbl, idx);
         if (uacpi_unlikely_error(ret))
             goto out;
 
@@ -1043,7 +1432,7 @@ static uacpi_status table_ctl(uacpi_size idx, struct table_ctl_request *req)
     }
 
     if (req->type & TABLE_CTL_PUT) {
-        ret = table_unref_unlocked(tbl);
+        ret = table_unref_unlocked(tbl, idx);
         if (uacpi_unlikely_error(ret))
             goto out;
     }
@@ -1115,6 +1504,21 @@ uacpi_status uacpi_table_unref(uacpi_table *tbl)
     });
 }
 
+uacpi_status uacpi_table_mapping_cache_get_stats(
+    uacpi_table_mapping_cache_stats *out_stats
+)
+{
+    UACPI_MUTEX_ACQUIRE_IF_EXISTS(table_mutex);
+
+    *out_stats = mapping_cache_stats;
+#if UACPI_TABLE_MAPPING_CACHE_SIZE != 0
+    out_stats->cached = mapping_cache_count;
+#endif
+
+    UACPI_MUTEX_RELEASE_IF_EXISTS(table_mutex);
+    return UACPI_STATUS_OK;
+}
+
 uacpi_u16 fadt_version_sizes[] = {
     116, 132, 244, 244, 268, 276
 };
@@ -30,6 +30,7 @@
 #include <uacpi/internal/dynamic_array.h>
 #include <uacpi/internal/log.h>
 #include <uacpi/internal/namespace.h>
+#include <uacpi/internal/interpreter.h>
 #include <uacpi/kernel_api.h>
 
 const uacpi_char *uacpi_object_type_to_string(uacpi_object_type type)
@@ -334,12 +335,135 @@ static object_ctor object_constructor_table[UACPI_OBJECT_MAX_TYPE_VALUE + 1] = {
     [UACPI_OBJECT_THERMAL_ZONE] = thermal_zone_alloc,
 };
 
+/*
+ * Objects are by far the most frequently allocated and freed structure during
+ * AML evaluation, most of them only living for the duration of a single
+ * opcode. Instead of going back to the kernel heap for every one of them,
+ * freed objects are kept on a free list and handed back out by
+ * uacpi_create_object().
+ */
+#ifndef UACPI_OBJECT_POOL_MAX_CACHED
+#define UACPI_OBJECT_POOL_MAX_CACHED 256
+#endif
+
+struct pooled_object {
+    struct pooled_object *next;
+};
+
+struct object_pool {
+    uacpi_handle lock;
+    struct pooled_object *head;
+    uacpi_u32 cached;
+    uacpi_object_pool_stats stats;
+};
+
+static struct object_pool g_object_pool;
+
+uacpi_status uacpi_initialize_object_pool(void)
+{
+    if (g_object_pool.lock != UACPI_NULL)
+        return UACPI_STATUS_OK;
+
+    g_object_pool.lock = uacpi_kernel_create_spinlock();
+    if (uacpi_unlikely(g_object_pool.lock == UACPI_NULL))
+        return UACPI_STATUS_OUT_OF_MEMORY;
+
+    return UACPI_STATUS_OK;
+}
+
+void uacpi_deinitialize_object_pool(void)
+{
+    struct pooled_object *obj, *next;
+    uacpi_handle lock = g_object_pool.lock;
+
+    if (lock == UACPI_NULL)
+        return;
+
+    obj = g_object_pool.head;
+    while (obj != UACPI_NULL) {
+        next = obj->next;
+        uacpi_free(obj, sizeof(uacpi_object));
+        obj = next;
+    }
+
+    uacpi_memzero(&g_object_pool, sizeof(g_object_pool));
+    uacpi_kernel_free_spinlock(lock);
+}
+
+void uacpi_object_pool_get_stats(uacpi_object_pool_stats *out_stats)
+{
+    uacpi_cpu_flags flags;
+
+    if (g_object_pool.lock == UACPI_NULL) {
+        *out_stats = g_object_pool.stats;
+        return;
+    }
+
+    flags = uacpi_kernel_lock_spinlock(g_object_pool.lock);
+    *out_stats = g_object_pool.stats;
+    out_stats->cached = g_object_pool.cached;
+    uacpi_kernel_unlock_spinlock(g_object_pool.lock, flags);
+}
+
+static uacpi_object *object_pool_alloc(void)
+{
+    struct pooled_object *obj = UACPI_NULL;
+    uacpi_cpu_flags flags;
+
+    // The pool is not usable until uacpi_initialize() has been called
+    if (uacpi_likely(g_object_pool.lock != UACPI_NULL)) {
+        flags = uacpi_kernel_lock_spinlock(g_object_pool.lock);
+
+        obj = g_object_pool.head;
+        if (obj != UACPI_NULL) {
+            g_object_pool.head = obj->next;
+            g_object_pool.cached--;
+            g_object_pool.stats.hits++;
+        } else {
+            g_object_pool.stats.misses++;
+        }
+
+        uacpi_kernel_unlock_spinlock(g_object_pool.lock, flags);
+    }
+
+    if (obj != UACPI_NULL) {
+        uacpi_memzero(obj, sizeof(uacpi_object));
+        return (uacpi_object*)obj;
+    }
+
+    return uacpi_kernel_calloc(1, sizeof(uacpi_object));
+}
+
+static void object_pool_free(uacpi_object *obj)
+{
+    struct pooled_object *pooled = (struct pooled_object*)obj;
+    uacpi_cpu_flags flags;
+
+    if (uacpi_likely(g_object_pool.lock != UACPI_NULL)) {
+        flags = uacpi_kernel_lock_spinlock(g_object_pool.lock);
+
+        if (g_object_pool.cached < UACPI_OBJECT_POOL_MAX_CACHED) {
+            pooled->next = g_object_pool.head;
+            g_object_pool.head = pooled;
+            g_object_pool.cached++;
+            pooled = UACPI_NULL;
+        } else {
+            g_object_pool.stats.releases++;
+        }
+
+        uacpi_kernel_unlock_spinlock(g_object_pool.lock, flags);
+    }
+
+    if (pooled != UACPI_NULL)
+        uacpi_free(obj, sizeof(*obj));
+}
+
 uacpi_object *uacpi_create_object(uacpi_object_type type)
 {
     uacpi_object *ret;
     object_ctor ctor;
 
-    ret = uacpi_kernel_calloc(1, sizeof(*ret));
+    ret = object_pool_alloc();
     if (uacpi_unlikely(ret == UACPI_NULL))
         return ret;
 
@@ -351,7 +475,7 @@ uacpi_object *uacpi_create_object(uacpi_object_type type)
         return ret;
 
     if (uacpi_unlikely(!ctor(ret))) {
-        uacpi_free(ret, sizeof(*ret));
+        object_pool_free(ret);
         return UACPI_NULL;
     }
 
@@ -407,7 +531,7 @@ static void free_plain_no_recurse(uacpi_object *obj, struct free_queue *queue)
         }
 
         // Don't call free_object here as that will recurse
-        uacpi_free(obj, sizeof(*obj));
+        object_pool_free(obj);
         break;
     default:
         /*
@@ -438,7 +562,7 @@ static void unref_chain_no_recurse(uacpi_object *obj, struct free_queue *queue)
             goto do_next;
 
         if (obj->type == UACPI_OBJECT_REFERENCE) {
-            uacpi_free(obj, sizeof(*obj));
+            object_pool_free(obj);
         } else {
             free_plain_no_recurse(obj, queue);
         }
@@ -636,6 +760,7 @@ static void free_method(uacpi_handle handle)
     uacpi_shareable_unref_and_delete_if_last(
         method->mutex, free_mutex
     );
+    uacpi_method_decode_cache_free(method);
 
     uacpi_free(method, sizeof(*method));
 }
@@ -698,7 +823,7 @@ static void free_object_storage(uacpi_object *obj)
 static void free_object(uacpi_object *obj)
 {
     free_object_storage(obj);
-    uacpi_free(obj, sizeof(*obj));
+    object_pool_free(obj);
 }
 
 static void make_chain_bugged(uacpi_object *obj)
@@ -758,7 +883,7 @@ void uacpi_object_unref(uacpi_object *obj)
     if (!obj)
         return;
 
-    parent_refcount = obj->shareable.reference_count;
+    parent_refcount = uacpi_shareable_refcount(obj);
 
     while (obj) {
         if (uacpi_unlikely(uacpi_bugged_shareable(obj))) {
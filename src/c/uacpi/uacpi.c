@@ -29,6 +29,7 @@
 #include <uacpi/internal/log.h>
 #include <uacpi/internal/context.h>
 #include <uacpi/internal/utilities.h>
+#include <uacpi/internal/types.h>
 #include <uacpi/internal/tables.h>
 #include <uacpi/internal/interpreter.h>
 #include <uacpi/internal/namespace.h>
@@ -36,15 +37,19 @@
 #include <uacpi/internal/registers.h>
 #include <uacpi/internal/event.h>
 #include <uacpi/internal/osi.h>
+#include <uacpi/internal/notify.h>
 
 struct uacpi_runtime_context g_uacpi_rt_ctx = { 0 };
 
 void uacpi_state_reset(void)
 {
+    uacpi_deinitialize_notify();
     uacpi_deinitialize_namespace();
+    uacpi_deinitialize_interpreter();
     uacpi_deinitialize_interfaces();
     uacpi_deinitialize_events();
     uacpi_deinitialize_tables();
+    uacpi_deinitialize_object_pool();
 
 #ifndef UACPI_REDUCED_HARDWARE
     if (g_uacpi_rt_ctx.global_lock_event)
@@ -306,6 +311,18 @@ uacpi_status uacpi_initialize(uacpi_u64 flags)
     if (g_uacpi_rt_ctx.max_call_stack_depth == 0)
         uacpi_context_set_max_call_stack_depth(UACPI_DEFAULT_MAX_CALL_STACK_DEPTH);
 
+    ret = uacpi_initialize_object_pool();
+    if (uacpi_unlikely_error(ret))
+        goto out_fatal_error;
+
+    ret = uacpi_initialize_notify();
+    if (uacpi_unlikely_error(ret))
+        goto out_fatal_error;
+
+    ret = uacpi_initialize_interpreter();
+    if (uacpi_unlikely_error(ret))
+        goto out_fatal_error;
+
     ret = uacpi_initialize_tables();
     if (uacpi_unlikely_error(ret))
         goto out_fatal_error;
@@ -611,29 +628,47 @@ uacpi_eval(uacpi_namespace_node *parent, const uacpi_char *path,
 {
     struct uacpi_namespace_node *node;
     uacpi_object *obj;
+    uacpi_status st;
 
     if (parent == UACPI_NULL && path == UACPI_NULL)
         return UACPI_STATUS_INVALID_ARGUMENT;
 
+    /*
+     * Nodes only lose their objects while AML is running, so this keeps the
+     * object alive from the point we look it up until the method returns.
+     */
+    st = uacpi_interpreter_enter();
+    if (uacpi_unlikely_error(st))
+        return st;
+
     if (path != UACPI_NULL) {
         node = uacpi_namespace_node_find(parent, path);
-        if (node == UACPI_NULL)
-            return UACPI_STATUS_NOT_FOUND;
+        if (node == UACPI_NULL) {
+            st = UACPI_STATUS_NOT_FOUND;
+            goto out;
+        }
     } else {
         node = parent;
     }
 
     obj = uacpi_namespace_node_get_object(node);
-    if (obj->type != UACPI_OBJECT_METHOD) {
+    if (uacpi_unlikely(obj == UACPI_NULL)) {
+        st = UACPI_STATUS_NOT_FOUND;
+    } else if (obj->type != UACPI_OBJECT_METHOD) {
         if (uacpi_likely(ret != UACPI_NULL)) {
             *ret = obj;
             uacpi_object_ref(obj);
         }
-
-        return UACPI_STATUS_OK;
+    } else {
+        st = uacpi_execute_control_method(node, obj->method, args, ret);
     }
 
-    return uacpi_execute_control_method(node, obj->method, args, ret);
+    if (path != UACPI_NULL)
+        uacpi_namespace_node_release(node);
+
+out:
+    uacpi_interpreter_exit();
+    return st;
 }
 
 #define TRACE_BAD_RET(path_fmt, type, ...)                                 \
@@ -1066,7 +1066,7 @@ uacpi_status uacpi_get_pci_routing_table(
     }
 
     size = table_pkg->count * sizeof(uacpi_pci_routing_table_entry);
-    table = uacpi_kernel_alloc(sizeof(uacpi_pci_routing_table) + size);
+    table = uacpi_kernel_calloc(1, sizeof(uacpi_pci_routing_table) + size);
     if (uacpi_unlikely(table == UACPI_NULL)) {
         uacpi_object_unref(obj);
         return UACPI_STATUS_OUT_OF_MEMORY;
@@ -1149,9 +1149,16 @@ out_bad_encoding:
 
 void uacpi_free_pci_routing_table(uacpi_pci_routing_table *table)
 {
+    uacpi_size i;
+
     if (table == UACPI_NULL)
         return;
 
+    for (i = 0; i < table->num_entries; ++i) {
+        if (table->entries[i].source != UACPI_NULL)
+            uacpi_namespace_node_release(table->entries[i].source);
+    }
+
     uacpi_free(
         table,
         sizeof(uacpi_pci_routing_table) +
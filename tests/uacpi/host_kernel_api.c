@@ -0,0 +1,332 @@
+/**
+ * @file host_kernel_api.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Just enough of the uacpi_kernel_* API to link uACPI into a host program.
+ * Memory, locks and time come from libc and pthreads. There is no firmware
+ * behind it: physical memory is identity mapped, I/O and PCI read as zero and
+ * discard writes, and work items run on the calling thread.
+*/
+#include <uacpi/kernel_api.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct host_event {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uacpi_u64 counter;
+};
+
+static struct timespec host_deadline(uacpi_u16 timeout) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += timeout / 1000;
+	ts.tv_nsec += (timeout % 1000) * 1000000L;
+
+	if (ts.tv_nsec >= 1000000000L) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000L;
+	}
+
+	return ts;
+}
+
+uacpi_status uacpi_kernel_get_rsdp(uacpi_phys_addr *out_rdsp_address) {
+	(void)out_rdsp_address;
+	return UACPI_STATUS_NOT_FOUND;
+}
+
+uacpi_status uacpi_kernel_raw_memory_read(uacpi_phys_addr address, uacpi_u8 byte_width, uacpi_u64 *out_value) {
+	(void)address;
+	(void)byte_width;
+	*out_value = 0;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_raw_memory_write(uacpi_phys_addr address, uacpi_u8 byte_width, uacpi_u64 in_value) {
+	(void)address;
+	(void)byte_width;
+	(void)in_value;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_raw_io_read(uacpi_io_addr address, uacpi_u8 byte_width, uacpi_u64 *out_value) {
+	(void)address;
+	(void)byte_width;
+	*out_value = 0;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_raw_io_write(uacpi_io_addr address, uacpi_u8 byte_width, uacpi_u64 in_value) {
+	(void)address;
+	(void)byte_width;
+	(void)in_value;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_pci_read(uacpi_pci_address *address, uacpi_size offset, uacpi_u8 byte_width, uacpi_u64 *value) {
+	(void)address;
+	(void)offset;
+	(void)byte_width;
+	*value = 0;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_pci_write(uacpi_pci_address *address, uacpi_size offset, uacpi_u8 byte_width, uacpi_u64 value) {
+	(void)address;
+	(void)offset;
+	(void)byte_width;
+	(void)value;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_io_map(uacpi_io_addr base, uacpi_size len, uacpi_handle *out_handle) {
+	(void)len;
+	*out_handle = (uacpi_handle)(uintptr_t)base;
+	return UACPI_STATUS_OK;
+}
+
+void uacpi_kernel_io_unmap(uacpi_handle handle) {
+	(void)handle;
+}
+
+uacpi_status uacpi_kernel_io_read(uacpi_handle handle, uacpi_size offset, uacpi_u8 byte_width, uacpi_u64 *value) {
+	return uacpi_kernel_raw_io_read((uintptr_t)handle + offset, byte_width, value);
+}
+
+uacpi_status uacpi_kernel_io_write(uacpi_handle handle, uacpi_size offset, uacpi_u8 byte_width, uacpi_u64 value) {
+	return uacpi_kernel_raw_io_write((uintptr_t)handle + offset, byte_width, value);
+}
+
+void *uacpi_kernel_map(uacpi_phys_addr addr, uacpi_size len) {
+	(void)len;
+	return (void *)(uintptr_t)addr;
+}
+
+void uacpi_kernel_unmap(void *addr, uacpi_size len) {
+	(void)addr;
+	(void)len;
+}
+
+void *uacpi_kernel_alloc(uacpi_size size) {
+	return malloc(size);
+}
+
+void *uacpi_kernel_calloc(uacpi_size count, uacpi_size size) {
+	return calloc(count, size);
+}
+
+#ifndef UACPI_SIZED_FREES
+void uacpi_kernel_free(void *mem) {
+	free(mem);
+}
+#else
+void uacpi_kernel_free(void *mem, uacpi_size size_hint) {
+	(void)size_hint;
+	free(mem);
+}
+#endif
+
+void uacpi_kernel_log(uacpi_log_level level, const uacpi_char *str) {
+	(void)level;
+	fputs(str, stderr);
+}
+
+uacpi_u64 uacpi_kernel_get_ticks(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 10000000ull + ts.tv_nsec / 100;
+}
+
+void uacpi_kernel_stall(uacpi_u8 usec) {
+	uacpi_u64 end = uacpi_kernel_get_ticks() + usec * 10ull;
+
+	while (uacpi_kernel_get_ticks() < end);
+}
+
+void uacpi_kernel_sleep(uacpi_u64 msec) {
+	struct timespec ts = {
+		.tv_sec = msec / 1000,
+		.tv_nsec = (msec % 1000) * 1000000L,
+	};
+
+	nanosleep(&ts, NULL);
+}
+
+uacpi_handle uacpi_kernel_create_mutex(void) {
+	pthread_mutex_t *mutex = malloc(sizeof(*mutex));
+
+	if (mutex != NULL) {
+		pthread_mutex_init(mutex, NULL);
+	}
+
+	return mutex;
+}
+
+void uacpi_kernel_free_mutex(uacpi_handle handle) {
+	pthread_mutex_destroy(handle);
+	free(handle);
+}
+
+uacpi_thread_id uacpi_kernel_get_thread_id(void) {
+	return (uacpi_thread_id)pthread_self();
+}
+
+uacpi_bool uacpi_kernel_acquire_mutex(uacpi_handle handle, uacpi_u16 timeout) {
+	struct timespec deadline;
+
+	if (timeout == 0) {
+		return pthread_mutex_trylock(handle) == 0;
+	}
+
+	if (timeout == 0xFFFF) {
+		return pthread_mutex_lock(handle) == 0;
+	}
+
+	deadline = host_deadline(timeout);
+
+	return pthread_mutex_timedlock(handle, &deadline) == 0;
+}
+
+void uacpi_kernel_release_mutex(uacpi_handle handle) {
+	pthread_mutex_unlock(handle);
+}
+
+uacpi_handle uacpi_kernel_create_event(void) {
+	struct host_event *event = calloc(1, sizeof(*event));
+
+	if (event != NULL) {
+		pthread_mutex_init(&event->lock, NULL);
+		pthread_cond_init(&event->cond, NULL);
+	}
+
+	return event;
+}
+
+void uacpi_kernel_free_event(uacpi_handle handle) {
+	struct host_event *event = handle;
+
+	pthread_cond_destroy(&event->cond);
+	pthread_mutex_destroy(&event->lock);
+	free(event);
+}
+
+uacpi_bool uacpi_kernel_wait_for_event(uacpi_handle handle, uacpi_u16 timeout) {
+	struct host_event *event = handle;
+	struct timespec deadline = host_deadline(timeout);
+	uacpi_bool ret;
+	int err = 0;
+
+	pthread_mutex_lock(&event->lock);
+
+	while (event->counter == 0 && err != ETIMEDOUT && timeout != 0) {
+		if (timeout == 0xFFFF) {
+			pthread_cond_wait(&event->cond, &event->lock);
+		} else {
+			err = pthread_cond_timedwait(&event->cond, &event->lock, &deadline);
+		}
+	}
+
+	ret = event->counter != 0;
+
+	if (ret) {
+		event->counter--;
+	}
+
+	pthread_mutex_unlock(&event->lock);
+
+	return ret;
+}
+
+void uacpi_kernel_signal_event(uacpi_handle handle) {
+	struct host_event *event = handle;
+
+	pthread_mutex_lock(&event->lock);
+	event->counter++;
+	pthread_cond_signal(&event->cond);
+	pthread_mutex_unlock(&event->lock);
+}
+
+void uacpi_kernel_reset_event(uacpi_handle handle) {
+	struct host_event *event = handle;
+
+	pthread_mutex_lock(&event->lock);
+	event->counter = 0;
+	pthread_mutex_unlock(&event->lock);
+}
+
+uacpi_status uacpi_kernel_handle_firmware_request(uacpi_firmware_request *request) {
+	(void)request;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_install_interrupt_handler(uacpi_u32 irq, uacpi_interrupt_handler handler, uacpi_handle ctx, uacpi_handle *out_irq_handle) {
+	(void)irq;
+	(void)handler;
+	(void)ctx;
+	*out_irq_handle = NULL;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_uninstall_interrupt_handler(uacpi_interrupt_handler handler, uacpi_handle irq_handle) {
+	(void)handler;
+	(void)irq_handle;
+	return UACPI_STATUS_OK;
+}
+
+uacpi_handle uacpi_kernel_create_spinlock(void) {
+	return uacpi_kernel_create_mutex();
+}
+
+void uacpi_kernel_free_spinlock(uacpi_handle handle) {
+	uacpi_kernel_free_mutex(handle);
+}
+
+uacpi_cpu_flags uacpi_kernel_lock_spinlock(uacpi_handle handle) {
+	pthread_mutex_lock(handle);
+	return 0;
+}
+
+void uacpi_kernel_unlock_spinlock(uacpi_handle handle, uacpi_cpu_flags flags) {
+	(void)flags;
+	pthread_mutex_unlock(handle);
+}
+
+uacpi_status uacpi_kernel_schedule_work(uacpi_work_type type, uacpi_work_handler handler, uacpi_handle ctx) {
+	(void)type;
+	handler(ctx);
+	return UACPI_STATUS_OK;
+}
+
+uacpi_status uacpi_kernel_wait_for_work_completion(void) {
+	return UACPI_STATUS_OK;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file shareable_stress.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Hammers uacpi_shareable reference counting from several threads at once and
+ * checks that the compare-exchange loops keep the bugged semantics: a shareable
+ * is freed exactly once, and a zero or saturated count sticks at
+ * BUGGED_REFCOUNT so the shareable is leaked instead of freed.
+*/
+#include <uacpi/internal/shareable.h>
+#include <uacpi/platform/atomic.h>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Mirrors the private definition in uacpi/shareable.c
+#define BUGGED_REFCOUNT 0xFFFFFFFF
+
+#define THREADS 8
+#define PAIRS_PER_THREAD 200000
+#define RACE_ROUNDS 20000
+
+struct test_shareable {
+	struct uacpi_shareable shareable;
+	uacpi_u32 frees;
+};
+
+static struct test_shareable object = { 0 };
+static pthread_barrier_t barrier;
+static int failures = 0;
+
+#define CHECK(cond, ...) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: ", __func__, __LINE__); \
+			fprintf(stderr, __VA_ARGS__); \
+			fprintf(stderr, "\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static void do_free(uacpi_handle handle) {
+	struct test_shareable *shareable = handle;
+	__atomic_fetch_add(&shareable->frees, 1, __ATOMIC_ACQ_REL);
+}
+
+static void reset(uacpi_u32 count) {
+	uacpi_atomic_store32(&object.shareable.reference_count, count);
+	uacpi_atomic_store32(&object.frees, 0);
+}
+
+static void run_threads(void *(*func)(void *)) {
+	pthread_t threads[THREADS];
+
+	for (uintptr_t i = 0; i < THREADS; i++) {
+		pthread_create(&threads[i], NULL, func, (void *)i);
+	}
+
+	for (int i = 0; i < THREADS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+}
+
+static void *ref_unref_pairs(void *arg) {
+	(void)arg;
+
+	pthread_barrier_wait(&barrier);
+
+	for (int i = 0; i < PAIRS_PER_THREAD; i++) {
+		uacpi_shareable_ref(&object);
+		uacpi_shareable_unref_and_delete_if_last(&object, do_free);
+	}
+
+	return NULL;
+}
+
+static void test_ref_unref_pairs() {
+	reset(1);
+	run_threads(ref_unref_pairs);
+
+	CHECK(uacpi_shareable_refcount(&object) == 1, "count is %u, expected 1",
+	      uacpi_shareable_refcount(&object));
+	CHECK(object.frees == 0, "freed %u times while still referenced", object.frees);
+
+	uacpi_shareable_unref_and_delete_if_last(&object, do_free);
+	CHECK(object.frees == 1, "freed %u times, expected 1", object.frees);
+}
+
+static void *last_unref(void *arg) {
+	(void)arg;
+
+	pthread_barrier_wait(&barrier);
+	uacpi_shareable_unref_and_delete_if_last(&object, do_free);
+
+	return NULL;
+}
+
+static void test_last_unref() {
+	for (int i = 0; i < RACE_ROUNDS / 100; i++) {
+		reset(THREADS);
+		run_threads(last_unref);
+
+		CHECK(object.frees == 1, "round %d: freed %u times, expected 1", i,
+		      object.frees);
+		CHECK(uacpi_shareable_refcount(&object) == 0, "round %d: count is %u",
+		      i, uacpi_shareable_refcount(&object));
+	}
+}
+
+static void *try_ref_or_drop(void *arg) {
+	uintptr_t id = (uintptr_t)arg;
+
+	pthread_barrier_wait(&barrier);
+
+	// Thread 0 owns the only reference, everyone else races it for one
+	if (id != 0 && !uacpi_shareable_try_ref(&object)) {
+		return NULL;
+	}
+
+	if (id != 0 && uacpi_atomic_load32(&object.frees) != 0) {
+		__atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+		fprintf(stderr, "try_ref succeeded on a freed shareable\n");
+	}
+
+	uacpi_shareable_unref_and_delete_if_last(&object, do_free);
+
+	return NULL;
+}
+
+static void test_try_ref_vs_last_unref() {
+	for (int i = 0; i < RACE_ROUNDS / 100; i++) {
+		reset(1);
+		run_threads(try_ref_or_drop);
+
+		CHECK(object.frees == 1, "round %d: freed %u times, expected 1", i,
+		      object.frees);
+	}
+
+	reset(0);
+	CHECK(!uacpi_shareable_try_ref(&object), "try_ref on a dead shareable");
+	CHECK(uacpi_shareable_refcount(&object) == 0, "try_ref changed a zero count");
+}
+
+static void *ref_many(void *arg) {
+	(void)arg;
+
+	pthread_barrier_wait(&barrier);
+
+	for (int i = 0; i < 16; i++) {
+		uacpi_shareable_ref(&object);
+	}
+
+	// Everyone has to be done saturating it before anyone starts dropping refs
+	pthread_barrier_wait(&barrier);
+
+	for (int i = 0; i < 32; i++) {
+		uacpi_shareable_unref_and_delete_if_last(&object, do_free);
+	}
+
+	return NULL;
+}
+
+static void test_saturation() {
+	// Overflows half way through the increments, the decrements must not undo it
+	reset(BUGGED_REFCOUNT - (THREADS * 16) / 2);
+	run_threads(ref_many);
+
+	CHECK(uacpi_shareable_refcount(&object) == BUGGED_REFCOUNT,
+	      "count is %#x after saturating", uacpi_shareable_refcount(&object));
+	CHECK(uacpi_bugged_shareable(&object), "saturated shareable isn't bugged");
+	CHECK(object.frees == 0, "saturated shareable freed %u times", object.frees);
+	CHECK(uacpi_shareable_try_ref(&object), "try_ref failed on a leaked shareable");
+}
+
+static void *unref_past_zero(void *arg) {
+	(void)arg;
+
+	pthread_barrier_wait(&barrier);
+
+	for (int i = 0; i < 1000; i++) {
+		uacpi_shareable_unref_and_delete_if_last(&object, do_free);
+	}
+
+	uacpi_shareable_ref(&object);
+
+	return NULL;
+}
+
+static void test_underflow() {
+	// Exactly one caller takes it 1 -> 0, everyone after that must mark it bugged
+	reset(1);
+	run_threads(unref_past_zero);
+
+	CHECK(object.frees == 1, "freed %u times, expected 1", object.frees);
+	CHECK(uacpi_shareable_refcount(&object) == BUGGED_REFCOUNT,
+	      "count is %#x after underflowing", uacpi_shareable_refcount(&object));
+
+	reset(0);
+	CHECK(uacpi_bugged_shareable(&object), "zero count isn't bugged");
+	CHECK(uacpi_shareable_refcount(&object) == BUGGED_REFCOUNT,
+	      "zero count wasn't made sticky");
+}
+
+int main() {
+	pthread_barrier_init(&barrier, NULL, THREADS);
+
+	test_ref_unref_pairs();
+	test_last_unref();
+	test_try_ref_vs_last_unref();
+	test_saturation();
+	test_underflow();
+
+	pthread_barrier_destroy(&barrier);
+
+	if (failures != 0) {
+		fprintf(stderr, "%d check(s) failed\n", failures);
+		return 1;
+	}
+
+	printf("uacpi_shareable: all checks passed\n");
+
+	return 0;
+}
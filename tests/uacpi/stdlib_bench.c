@@ -0,0 +1,235 @@
+/**
+ * @file stdlib_bench.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Times uACPI's memcpy/memmove/memset/memcmp and table checksum against the
+ * byte loops they replaced, for every power of two from 1B to 256KiB, and
+ * checks that uACPI's helpers still produce the right results. memmove is measured on an
+ * overlapping backward move, as forward moves are memcpy.
+ *
+ * Pass --quick to only check results with a handful of iterations per size.
+*/
+#include "stdlib_reference.h"
+
+#include <uacpi/internal/stdlib.h>
+#include <uacpi/internal/tables.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_SIZE (256 * 1024)
+// Bytes processed per size and implementation, enough to get past timer noise
+#define BYTES_PER_RUN (16 * 1024 * 1024)
+#define MEMMOVE_OVERLAP 8
+
+enum bench_op {
+	BENCH_MEMCPY,
+	BENCH_MEMMOVE,
+	BENCH_MEMSET,
+	BENCH_MEMCMP,
+	BENCH_CHECKSUM,
+	BENCH_MAX,
+};
+
+static const char *op_names[BENCH_MAX] = {
+	[BENCH_MEMCPY] = "memcpy",
+	[BENCH_MEMMOVE] = "memmove",
+	[BENCH_MEMSET] = "memset",
+	[BENCH_MEMCMP] = "memcmp",
+	[BENCH_CHECKSUM] = "checksum",
+};
+
+static uacpi_u8 *src = NULL;
+static uacpi_u8 *dst = NULL;
+static volatile uacpi_i32 sink = 0;
+static int failures = 0;
+
+static double now_ns() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uacpi_u8 checksum(void *table, uacpi_size size) {
+	// Only a buffer that sums to zero stays quiet, see fill_buffers()
+	return uacpi_verify_table_checksum(table, size) == UACPI_STATUS_OK ? 0 : 1;
+}
+
+static void run_op(enum bench_op op, int reference, uacpi_size size) {
+	switch (op) {
+	case BENCH_MEMCPY:
+		(reference ? ref_memcpy : uacpi_memcpy)(dst, src, size);
+		break;
+	case BENCH_MEMMOVE:
+		(reference ? ref_memmove : uacpi_memmove)(dst + MEMMOVE_OVERLAP, dst, size);
+		break;
+	case BENCH_MEMSET:
+		(reference ? ref_memset : uacpi_memset)(dst, 0xA5, size);
+		break;
+	case BENCH_MEMCMP:
+		sink = (reference ? ref_memcmp : uacpi_memcmp)(dst, src, size);
+		break;
+	case BENCH_CHECKSUM:
+		sink = reference ? ref_checksum(src, size) : checksum(src, size);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * The last byte is picked so that the whole buffer sums to zero, which is what
+ * a valid table looks like to uacpi_verify_table_checksum().
+ */
+static void fill_buffers(uacpi_size size) {
+	uacpi_u8 sum = 0;
+
+	for (uacpi_size i = 0; i + 1 < size; i++) {
+		src[i] = (uacpi_u8)(i * 131 + 7);
+		sum += src[i];
+	}
+
+	src[size - 1] = (uacpi_u8)-sum;
+	memcpy(dst, src, size);
+}
+
+static void check_results(uacpi_size size) {
+	static uacpi_u8 expected[MAX_SIZE + MEMMOVE_OVERLAP];
+
+	fill_buffers(size);
+
+	memcpy(expected, src, size);
+	memset(dst, 0, size);
+	uacpi_memcpy(dst, src, size);
+	if (memcmp(dst, expected, size) != 0) {
+		fprintf(stderr, "memcpy: mismatch at %zu bytes\n", size);
+		failures++;
+	}
+
+	memcpy(expected, dst, size + MEMMOVE_OVERLAP);
+	memmove(expected + MEMMOVE_OVERLAP, expected, size);
+	uacpi_memmove(dst + MEMMOVE_OVERLAP, dst, size);
+	if (memcmp(dst, expected, size + MEMMOVE_OVERLAP) != 0) {
+		fprintf(stderr, "memmove: mismatch at %zu bytes\n", size);
+		failures++;
+	}
+
+	memset(expected, 0xA5, size);
+	uacpi_memset(dst, 0xA5, size);
+	if (memcmp(dst, expected, size) != 0) {
+		fprintf(stderr, "memset: mismatch at %zu bytes\n", size);
+		failures++;
+	}
+
+	fill_buffers(size);
+	dst[size - 1] ^= 1;
+	if ((uacpi_memcmp(dst, src, size) < 0) != (ref_memcmp(dst, src, size) < 0) ||
+	    uacpi_memcmp(src, src, size) != 0) {
+		fprintf(stderr, "memcmp: mismatch at %zu bytes\n", size);
+		failures++;
+	}
+
+	if (checksum(src, size) != 0 || ref_checksum(src, size) != 0) {
+		fprintf(stderr, "checksum: mismatch at %zu bytes\n", size);
+		failures++;
+	}
+
+	fill_buffers(size);
+}
+
+static double time_op(enum bench_op op, int reference, uacpi_size size, uacpi_size iterations) {
+	double begin;
+
+	// memcmp has to see equal buffers to scan all of them
+	fill_buffers(size);
+
+	// Warm up the caches and the CPUID probe
+	run_op(op, reference, size);
+
+	begin = now_ns();
+
+	for (uacpi_size i = 0; i < iterations; i++) {
+		run_op(op, reference, size);
+	}
+
+	return (now_ns() - begin) / iterations;
+}
+
+int main(int argc, char **argv) {
+	int quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+
+	src = malloc(MAX_SIZE);
+	dst = malloc(MAX_SIZE + MEMMOVE_OVERLAP);
+
+	if (src == NULL || dst == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	// Silence the checksum warnings, mismatches are reported by check_results()
+	g_uacpi_rt_ctx.log_level = UACPI_LOG_ERROR;
+
+	if (!quick) {
+		printf("%-9s %8s %12s %12s %10s %10s %7s\n", "op", "size", "byte ns",
+		       "uacpi ns", "byte GB/s", "uacpi GB/s", "speedup");
+	}
+
+	for (uacpi_size size = 1; size <= MAX_SIZE; size *= 2) {
+		uacpi_size iterations = quick ? 4 : BYTES_PER_RUN / size;
+
+		// One byte short of a power of two takes the tail paths after the word loops
+		if (size > 1) {
+			check_results(size - 1);
+		}
+
+		check_results(size);
+
+		for (int op = 0; op < BENCH_MAX; op++) {
+			double byte_ns = time_op(op, 1, size, iterations);
+			double uacpi_ns = time_op(op, 0, size, iterations);
+
+			if (quick) {
+				continue;
+			}
+
+			printf("%-9s %8zu %12.1f %12.1f %10.2f %10.2f %6.2fx\n", op_names[op],
+			       size, byte_ns, uacpi_ns, size / byte_ns, size / uacpi_ns,
+			       byte_ns / uacpi_ns);
+		}
+	}
+
+	free(src);
+	free(dst);
+
+	if (failures != 0) {
+		fprintf(stderr, "%d check(s) failed\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file stdlib_reference.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * The byte-at-a-time helpers uACPI shipped with before the word-at-a-time
+ * versions, kept as the baseline for stdlib_bench.c. Built with the same
+ * flags as the uACPI sources it is compared against.
+*/
+#include "stdlib_reference.h"
+
+void *ref_memcpy(void *dest, const void *src, uacpi_size count) {
+	uacpi_char *cd = dest;
+	const uacpi_char *cs = src;
+
+	while (count--) {
+		*cd++ = *cs++;
+	}
+
+	return dest;
+}
+
+void *ref_memmove(void *dest, const void *src, uacpi_size count) {
+	uacpi_char *cd = dest;
+	const uacpi_char *cs = src;
+
+	if (src < dest) {
+		cs += count;
+		cd += count;
+
+		while (count--) {
+			*--cd = *--cs;
+		}
+	} else {
+		while (count--) {
+			*cd++ = *cs++;
+		}
+	}
+
+	return dest;
+}
+
+void *ref_memset(void *dest, uacpi_i32 ch, uacpi_size count) {
+	uacpi_u8 fill = ch;
+	uacpi_u8 *cdest = dest;
+
+	while (count--) {
+		*cdest++ = fill;
+	}
+
+	return dest;
+}
+
+uacpi_i32 ref_memcmp(const void *lhs, const void *rhs, uacpi_size count) {
+	const uacpi_u8 *byte_lhs = lhs;
+	const uacpi_u8 *byte_rhs = rhs;
+
+	for (uacpi_size i = 0; i < count; ++i) {
+		if (byte_lhs[i] != byte_rhs[i]) {
+			return byte_lhs[i] - byte_rhs[i];
+		}
+	}
+
+	return 0;
+}
+
+uacpi_u8 ref_checksum(void *table, uacpi_size size) {
+	uacpi_u8 *bytes = table;
+	uacpi_u8 csum = 0;
+
+	for (uacpi_size i = 0; i < size; ++i) {
+		csum += bytes[i];
+	}
+
+	return csum;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file stdlib_reference.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-OS/Kernel - Operating System Kernel
+ * Copyright (C) 2023-2025 awewsomegamer
+ *
+ * This file is part of Arctan-OS/Kernel.
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+*/
+#ifndef ARC_TESTS_UACPI_STDLIB_REFERENCE_H
+#define ARC_TESTS_UACPI_STDLIB_REFERENCE_H
+
+#include <uacpi/types.h>
+
+void *ref_memcpy(void *dest, const void *src, uacpi_size count);
+void *ref_memmove(void *dest, const void *src, uacpi_size count);
+void *ref_memset(void *dest, uacpi_i32 ch, uacpi_size count);
+uacpi_i32 ref_memcmp(const void *lhs, const void *rhs, uacpi_size count);
+uacpi_u8 ref_checksum(void *table, uacpi_size size);
+
+#endif